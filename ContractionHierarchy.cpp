@@ -0,0 +1,423 @@
+#include "ContractionHierarchy.h"
+#include "MappedFile.h"
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <queue>
+
+namespace {
+    /**
+    Aresta do grafo sendo contraído: vizinho, vértice contraído no meio (-1 se for original) e peso.
+    */
+    struct OverlayEdge {
+        int target;
+        int middle;
+        double weight;
+    };
+
+    /**
+    Atalho u - w, com o peso do caminho u - v - w pelo vértice sendo contraído.
+    */
+    struct Shortcut {
+        int u;
+        int w;
+        double weight;
+    };
+
+    // Quantidade máxima de vértices explorados por uma busca de testemunha: menor ao estimar a prioridade (que é recalculada muitas vezes) e maior ao contrair de fato
+    const int PRIORITY_SETTLE_LIMIT = 50;
+    const int CONTRACTION_SETTLE_LIMIT = 500;
+
+    /**
+    Grafo que vai sendo contraído. adj[v] só tem vizinhos ainda não contraídos, no máximo uma aresta (a mais leve) por vizinho.
+    */
+    class Contractor {
+    private:
+        // Busca de testemunha
+        std::vector<double> dist;
+        std::vector<int> touched;
+        IndexedDaryHeap<4> heap;
+        std::vector<bool> is_target;
+        std::vector<double> max_after;
+        std::vector<Shortcut> pending; // Atalhos da contração atual
+
+        /**
+        Calcula em dist as distâncias a partir de source sem passar por avoid, parando quando a menor distância na heap passa de max_dist, quando targets_left vértices marcados em is_target foram explorados, ou depois de settle_limit vértices.
+        */
+        void witness_search(int source, int avoid, double max_dist, int targets_left, int settle_limit) {
+            double inf = std::numeric_limits<double>::infinity();
+            dist[source] = 0;
+            touched.push_back(source);
+            heap.push_or_decrease(source, 0);
+
+            int settled = 0;
+            while (!heap.empty() && targets_left > 0) {
+                double d;
+                int x = heap.pop(d);
+                if (d > max_dist || ++settled > settle_limit) break;
+                if (is_target[x]) targets_left--;
+
+                for (const OverlayEdge& e : adj[x]) {
+                    int y = e.target;
+                    if (y == avoid) continue;
+                    double nd = d + e.weight;
+                    if (nd < dist[y]) {
+                        if (dist[y] == inf) touched.push_back(y);
+                        dist[y] = nd;
+                        heap.push_or_decrease(y, nd);
+                    }
+                }
+            }
+            heap.clear();
+        }
+
+        void clear_witness() {
+            double inf = std::numeric_limits<double>::infinity();
+            for (int x : touched) dist[x] = inf;
+            touched.clear();
+        }
+
+        // Insere a aresta u - w em adj[u], ou só diminui o peso se já existir uma mais pesada - O(grau u)
+        void add_or_improve(int u, int w, double weight, int middle) {
+            for (OverlayEdge& e : adj[u]) {
+                if (e.target == w) {
+                    if (weight < e.weight) {
+                        e.weight = weight;
+                        e.middle = middle;
+                    }
+                    return;
+                }
+            }
+            adj[u].push_back(OverlayEdge{w, middle, weight});
+        }
+
+        // Guarda em pending os atalhos necessários para contrair v e retorna quantos são. Com um settle_limit menor, a busca de testemunha desiste antes e a quantidade pode ser maior que a necessária
+        int find_shortcuts(int v, int settle_limit) {
+            pending.clear();
+            const std::vector<OverlayEdge>& edges = adj[v];
+            int degree = edges.size();
+
+            // max_after[i] = maior peso entre edges[i], ..., edges[degree - 1]
+            max_after.assign(degree + 1, 0);
+            for (int i = degree - 1; i >= 0; i--) max_after[i] = std::max(max_after[i + 1], edges[i].weight);
+
+            // Para cada u = edges[i], uma busca a partir de u decide os atalhos para os w = edges[j], j > i
+            for (int j = 0; j < degree; j++) is_target[edges[j].target] = true;
+            for (int i = 0; i + 1 < degree; i++) {
+                int u = edges[i].target;
+                is_target[u] = false;
+                witness_search(u, v, edges[i].weight + max_after[i + 1], degree - i - 1, settle_limit);
+                for (int j = i + 1; j < degree; j++) {
+                    double via = edges[i].weight + edges[j].weight;
+                    // Sem um caminho de u até w, sem passar por v, tão curto quanto u - v - w: precisa de atalho
+                    if (dist[edges[j].target] > via) pending.push_back(Shortcut{u, edges[j].target, via});
+                }
+                clear_witness();
+            }
+            if (degree > 0) is_target[edges[degree - 1].target] = false;
+            return pending.size();
+        }
+
+    public:
+        std::vector<std::vector<OverlayEdge>> adj;
+        std::vector<int> contracted_neighbors;
+
+        explicit Contractor(const WeightedGraph& g) {
+            int n = g.get_n();
+            adj.resize(n + 1);
+            contracted_neighbors.assign(n + 1, 0);
+            dist.assign(n + 1, std::numeric_limits<double>::infinity());
+            is_target.assign(n + 1, false);
+            heap.reset(n + 1);
+
+            // As arestas de u estão em ordem crescente de vizinho, então arestas repetidas ficam juntas
+            for (int u = 1; u <= n; u++) {
+                for (const WeightedArc& a : g.weighted_neighbors(u)) {
+                    if (a.target == u) continue; // Laços nunca fazem parte de caminhos mínimos
+                    if (!adj[u].empty() && adj[u].back().target == a.target) {
+                        adj[u].back().weight = std::min<double>(adj[u].back().weight, a.weight);
+                    } else {
+                        adj[u].push_back(OverlayEdge{a.target, -1, static_cast<double>(a.weight)});
+                    }
+                }
+            }
+        }
+
+        /**
+        Prioridade de contração de v (menor = contrair antes): duas vezes a diferença de arestas (atalhos que a contração criaria menos arestas removidas), mais a quantidade de vizinhos já contraídos, para espalhar as contrações pelo grafo.
+        */
+        int priority(int v) {
+            return 2 * (find_shortcuts(v, PRIORITY_SETTLE_LIMIT) - static_cast<int>(adj[v].size())) + contracted_neighbors[v];
+        }
+
+        /**
+        Contrai v: insere os atalhos necessários e remove v das listas dos vizinhos. Retorna as arestas de v para os vizinhos não contraídos, que passam a ser as arestas para cima de v.
+        */
+        std::vector<OverlayEdge> contract(int v) {
+            find_shortcuts(v, CONTRACTION_SETTLE_LIMIT);
+            for (const Shortcut& s : pending) {
+                add_or_improve(s.u, s.w, s.weight, v);
+                add_or_improve(s.w, s.u, s.weight, v);
+            }
+
+            std::vector<OverlayEdge> upward;
+            upward.swap(adj[v]);
+            for (const OverlayEdge& e : upward) {
+                std::vector<OverlayEdge>& list = adj[e.target];
+                for (int i = 0; i < list.size(); i++) {
+                    if (list[i].target == v) {
+                        list[i] = list.back();
+                        list.pop_back();
+                        break;
+                    }
+                }
+                contracted_neighbors[e.target]++;
+            }
+            return upward;
+        }
+
+        int last_shortcut_count() const {
+            return pending.size();
+        }
+    };
+
+    const char CH_MAGIC[8] = {'G', 'R', 'A', 'F', 'O', 'C', 'H', '\0'};
+    const std::uint32_t CH_VERSION = 1;
+
+    /**
+    Cabeçalho do formato binário do índice. Depois dele vêm rank (n + 1 int, completado com zeros até um múltiplo de 8 bytes), up_offsets (n + 2 int64) e up_arcs (arcs registros de 16 bytes: target, middle e weight).
+    */
+    struct CHHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t flags;
+        std::int64_t n;
+        std::int64_t arcs;
+        std::int64_t shortcuts;
+    };
+    static_assert(sizeof(CHHeader) == 40, "O cabeçalho do índice deve ter 40 bytes, sem preenchimento");
+}
+
+ContractionHierarchy::ContractionHierarchy(const WeightedGraph& g) {
+    if (g.weight_stats().has_negative) throw std::runtime_error("ContractionHierarchy não aceita pesos negativos");
+    static_assert(sizeof(UpwardArc) == 16, "UpwardArc é gravado direto no arquivo");
+
+    n = g.get_n();
+    rank.assign(n + 1, -1);
+    std::vector<std::vector<OverlayEdge>> upward(n + 1);
+    Contractor contractor(g);
+
+    // Ordem de contração: fila com as prioridades atuais. Entradas com prioridade diferente de priority[v] são velhas e são ignoradas.
+    // Ao contrair v, as prioridades dos vizinhos são recalculadas. Além disso, ao sair da fila, a prioridade de v é recalculada (atualização preguiçosa), e se ficou pior que a próxima da fila, v volta para a fila
+    std::vector<int> priority(n + 1);
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<std::pair<int, int>>> order;
+    for (int v = 1; v <= n; v++) {
+        priority[v] = contractor.priority(v);
+        order.push(std::make_pair(priority[v], v));
+    }
+
+    int next_rank = 0;
+    while (!order.empty()) {
+        int p = order.top().first;
+        int v = order.top().second;
+        order.pop();
+        if (rank[v] != -1 || p != priority[v]) continue;
+
+        priority[v] = contractor.priority(v);
+        if (!order.empty() && priority[v] > order.top().first) {
+            order.push(std::make_pair(priority[v], v));
+            continue;
+        }
+
+        upward[v] = contractor.contract(v);
+        shortcuts += contractor.last_shortcut_count();
+        rank[v] = next_rank++;
+
+        for (const OverlayEdge& e : upward[v]) {
+            priority[e.target] = contractor.priority(e.target);
+            order.push(std::make_pair(priority[e.target], e.target));
+        }
+    }
+
+    // Juntar as arestas para cima em um único vetor - O(n + m + atalhos)
+    up_offsets.assign(n + 2, 0);
+    for (int v = 1; v <= n; v++) up_offsets[v + 1] = up_offsets[v] + upward[v].size();
+    up_arcs.reserve(up_offsets[n + 1]);
+    for (int v = 1; v <= n; v++) {
+        for (const OverlayEdge& e : upward[v]) up_arcs.push_back(UpwardArc{e.target, e.middle, e.weight});
+        std::vector<OverlayEdge>().swap(upward[v]);
+    }
+}
+
+const ContractionHierarchy::UpwardArc& ContractionHierarchy::find_arc(int a, int b) const {
+    int low = rank[a] < rank[b] ? a : b;
+    int high = low == a ? b : a;
+    for (long long i = up_offsets[low]; i < up_offsets[low + 1]; i++) {
+        if (up_arcs[i].target == high) return up_arcs[i];
+    }
+    throw std::runtime_error("ContractionHierarchy corrompida: aresta não encontrada");
+}
+
+void ContractionHierarchy::unpack(int a, int b, std::vector<int>& path) const {
+    // Pilha em vez de recursão: cadeias de atalhos podem ser longas
+    std::vector<std::pair<int, int>> stack = {{a, b}};
+    while (!stack.empty()) {
+        std::pair<int, int> top = stack.back();
+        stack.pop_back();
+
+        const UpwardArc& arc = find_arc(top.first, top.second);
+        if (arc.middle == -1) {
+            path.push_back(top.second);
+        } else {
+            // Primeiro a metade de top.first até o meio, depois a do meio até top.second
+            stack.push_back(std::make_pair(arc.middle, top.second));
+            stack.push_back(std::make_pair(top.first, arc.middle));
+        }
+    }
+}
+
+PathQueryResult ContractionHierarchy::shortest_path(int u, int v) const {
+    PointToPointWorkspace workspace;
+    return shortest_path(u, v, workspace);
+}
+
+PathQueryResult ContractionHierarchy::shortest_path(int u, int v, PointToPointWorkspace& workspace) const {
+    assert(1 <= u && u <= n && 1 <= v && v <= n);
+
+    double inf = std::numeric_limits<double>::infinity();
+    PathQueryResult result;
+    result.dist = inf;
+
+    workspace.prepare(n);
+    std::vector<double>* dist = workspace.dist;
+    std::vector<int>* parent = workspace.parent;
+    IndexedDaryHeap<4>* H = workspace.heap;
+
+    int roots[2] = {u, v};
+    for (int side = 0; side < 2; side++) {
+        workspace.touch(roots[side]);
+        dist[side][roots[side]] = 0;
+        parent[side][roots[side]] = roots[side];
+        H[side].push_or_decrease(roots[side], 0);
+    }
+
+    double best = u == v ? 0 : inf;
+    int meet = u == v ? u : -1;
+
+    // As duas buscas só sobem. Cada uma para quando a menor chave da sua heap alcança best: o encontro no vértice de maior rank de um caminho mínimo já foi visto
+    while (true) {
+        bool done[2];
+        for (int side = 0; side < 2; side++) done[side] = H[side].empty() || H[side].top_key() >= best;
+        if (done[0] && done[1]) break;
+
+        int side = done[0] ? 1 : done[1] ? 0 : (H[0].size() <= H[1].size() ? 0 : 1);
+        int other = 1 - side;
+
+        double dx;
+        int x = H[side].pop(dx);
+        result.settled++;
+
+        for (long long i = up_offsets[x]; i < up_offsets[x + 1]; i++) {
+            const UpwardArc& a = up_arcs[i];
+            int y = a.target;
+            double ndist = dx + a.weight;
+
+            if (ndist < dist[side][y]) {
+                workspace.touch(y);
+                dist[side][y] = ndist;
+                parent[side][y] = x;
+                H[side].push_or_decrease(y, ndist);
+            }
+            if (dist[other][y] != inf && ndist + dist[other][y] < best) {
+                best = ndist + dist[other][y];
+                meet = y;
+            }
+        }
+    }
+
+    if (meet != -1) {
+        result.dist = best;
+
+        // Caminho no grafo com atalhos: de u até meet, depois de meet até v
+        std::vector<int> hierarchy_path;
+        for (int x = meet; x != u; x = parent[0][x]) hierarchy_path.push_back(x);
+        hierarchy_path.push_back(u);
+        std::reverse(hierarchy_path.begin(), hierarchy_path.end());
+        for (int x = meet; x != v; ) {
+            x = parent[1][x];
+            hierarchy_path.push_back(x);
+        }
+
+        // Expandir cada atalho nos vértices originais
+        result.path.push_back(u);
+        for (int i = 0; i + 1 < hierarchy_path.size(); i++) {
+            unpack(hierarchy_path[i], hierarchy_path[i + 1], result.path);
+        }
+    }
+
+    workspace.clear();
+    return result;
+}
+
+void ContractionHierarchy::save(const std::string& filename) const {
+    CHHeader header;
+    std::memcpy(header.magic, CH_MAGIC, sizeof(CH_MAGIC));
+    header.version = CH_VERSION;
+    header.flags = 0;
+    header.n = n;
+    header.arcs = up_arcs.size();
+    header.shortcuts = shortcuts;
+
+    std::FILE* file = std::fopen(filename.c_str(), "wb");
+    if (!file) throw std::runtime_error("Não foi possível criar o arquivo " + filename);
+
+    std::size_t rank_bytes = rank.size() * sizeof(int);
+    std::size_t padding = (rank_bytes + 7) / 8 * 8 - rank_bytes;
+    const char zeros[8] = {0};
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && std::fwrite(rank.data(), sizeof(int), rank.size(), file) == rank.size();
+    ok = ok && std::fwrite(zeros, 1, padding, file) == padding;
+    ok = ok && std::fwrite(up_offsets.data(), sizeof(long long), up_offsets.size(), file) == up_offsets.size();
+    ok = ok && std::fwrite(up_arcs.data(), sizeof(UpwardArc), up_arcs.size(), file) == up_arcs.size();
+
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) throw std::runtime_error("Erro ao escrever o arquivo " + filename);
+}
+
+ContractionHierarchy ContractionHierarchy::load(const std::string& filename) {
+    MappedFile file(filename);
+    const char* data = file.data();
+    std::size_t size = file.size();
+
+    CHHeader header;
+    if (size < sizeof(header)) throw std::runtime_error("Arquivo " + filename + " não é uma ContractionHierarchy");
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, CH_MAGIC, sizeof(CH_MAGIC)) != 0 || header.version != CH_VERSION) {
+        throw std::runtime_error("Arquivo " + filename + " não é uma ContractionHierarchy (ou é de outra versão)");
+    }
+    if (header.n < 1 || header.n > std::numeric_limits<int>::max() || header.arcs < 0) {
+        throw std::runtime_error("Arquivo " + filename + " tem um cabeçalho inválido");
+    }
+
+    std::size_t rank_start = sizeof(header);
+    std::size_t offsets_start = rank_start + ((header.n + 1) * sizeof(int) + 7) / 8 * 8;
+    std::size_t arcs_start = offsets_start + (header.n + 2) * sizeof(long long);
+    if (size != arcs_start + header.arcs * sizeof(UpwardArc)) throw std::runtime_error("Arquivo " + filename + " está truncado ou corrompido");
+
+    ContractionHierarchy ch;
+    ch.n = header.n;
+    ch.shortcuts = header.shortcuts;
+    ch.rank.resize(ch.n + 1);
+    ch.up_offsets.resize(ch.n + 2);
+    ch.up_arcs.resize(header.arcs);
+    std::memcpy(ch.rank.data(), data + rank_start, ch.rank.size() * sizeof(int));
+    std::memcpy(ch.up_offsets.data(), data + offsets_start, ch.up_offsets.size() * sizeof(long long));
+    std::memcpy(ch.up_arcs.data(), data + arcs_start, ch.up_arcs.size() * sizeof(UpwardArc));
+    if (ch.up_offsets[ch.n + 1] != header.arcs) throw std::runtime_error("Arquivo " + filename + " está corrompido");
+    return ch;
+}
@@ -0,0 +1,90 @@
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+#include "Graph.h"
+#include <vector>
+#include <string>
+
+/**
+Contraction Hierarchies: índice para consultas de caminho mínimo em um WeightedGraph que não muda.
+Na construção, os vértices são contraídos um a um, do menos ao mais importante. Contrair v significa removê-lo do grafo e, para cada par de vizinhos u, w cujo caminho mínimo passava por v, inserir um atalho u - w com o peso de u - v - w. A ordem de contração (rank) é escolhida pela diferença de arestas: quantos atalhos a contração criaria menos quantas arestas ela remove.
+Cada aresta (original ou atalho) é guardada só no vértice de menor rank, apontando "para cima". Uma consulta faz um Dijkstra bidirecional que só sobe, e por isso explora poucos vértices. Cada atalho lembra o vértice contraído por onde passa, então o caminho pode ser expandido de volta para vértices e arestas do grafo original.
+O índice não depende do grafo depois de construído, e pode ser salvo e carregado com save e load.
+*/
+class ContractionHierarchy {
+private:
+    /**
+    Aresta para cima: o vizinho de rank maior, o peso e o vértice contraído no meio (-1 se for uma aresta do grafo original).
+    */
+    struct UpwardArc {
+        int target;
+        int middle;
+        double weight;
+    };
+
+    int n = 0;
+    std::vector<int> rank;              // rank[v] = posição de v na ordem de contração (0 = primeiro a ser contraído)
+    std::vector<long long> up_offsets;  // As arestas para cima de v são up_arcs[up_offsets[v]], ..., up_arcs[up_offsets[v + 1] - 1]. n + 2 entradas
+    std::vector<UpwardArc> up_arcs;
+    long long shortcuts = 0;
+
+    // Construtor vazio para load
+    ContractionHierarchy() = default;
+
+    // Retorna a aresta entre a e b, guardada no de menor rank dos dois - O(grau para cima)
+    const UpwardArc& find_arc(int a, int b) const;
+
+    // Acrescenta a path os vértices do caminho original correspondente à aresta a - b, sem a e com b
+    void unpack(int a, int b, std::vector<int>& path) const;
+
+public:
+    /**
+    Constrói o índice contraindo todos os vértices de g. Lança std::runtime_error se algum peso for negativo.
+    As buscas de testemunha (que decidem se um atalho é necessário) são limitadas, então alguns atalhos podem ser desnecessários, mas nunca falta um atalho necessário.
+    Funciona melhor em grafos com estrutura geométrica (grades, malhas viárias). Em grafos aleatórios, a quantidade de atalhos cresce muito nos vértices contraídos por último.
+
+    O(n log n + soma das buscas de testemunha) de tempo e O(n + m + atalhos) de memória
+    */
+    explicit ContractionHierarchy(const WeightedGraph& g);
+
+    int get_n() const {
+        return n;
+    }
+
+    /**
+    Retorna a quantidade de atalhos inseridos na construção.
+
+    O(1)
+    */
+    long long shortcut_count() const {
+        return shortcuts;
+    }
+
+    /**
+    Retorna a distância e um caminho mínimo de u até v no grafo original (da mesma forma que reconstruct_path: de u até v, incluindo ambos). Caso não estejam conectados, a distância é std::numeric_limits<double>::infinity() e o caminho é vazio.
+
+    u e v devem ser vértices válidos.
+    */
+    PathQueryResult shortest_path(int u, int v) const;
+
+    /**
+    Igual a shortest_path acima, mas usando a memória auxiliar de workspace.
+    */
+    PathQueryResult shortest_path(int u, int v, PointToPointWorkspace& workspace) const;
+
+    /**
+    Salva o índice em filename, em formato binário. Lança std::runtime_error se não conseguir escrever.
+
+    O(n + m + atalhos)
+    */
+    void save(const std::string& filename) const;
+
+    /**
+    Carrega um índice salvo com save. Lança std::runtime_error se o arquivo não existir ou não for um índice válido.
+
+    O(n + m + atalhos)
+    */
+    static ContractionHierarchy load(const std::string& filename);
+};
+
+#endif
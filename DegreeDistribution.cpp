@@ -0,0 +1,266 @@
+#include "DegreeDistribution.h"
+#include "Parallel.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+
+namespace {
+    const char DD_MAGIC[8] = {'G', 'R', 'A', 'F', 'O', 'D', 'D', '\0'};
+    const std::uint32_t DD_VERSION = 1;
+
+    /**
+    Cabeçalho do formato binário da distribuição. Depois dele vêm distinct pares int64 (grau, quantidade de vértices).
+    */
+    struct DDHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t flags;
+        std::int64_t n;
+        std::int64_t degree_sum;
+        std::int64_t max_degree;
+        std::int64_t distinct;
+        double alpha;
+        std::int64_t d_min;
+        double ks_distance;
+    };
+    static_assert(sizeof(DDHeader) == 72, "O cabeçalho da distribuição deve ter 72 bytes, sem preenchimento");
+
+    // Menor quantidade de vértices na cauda para que um grau seja candidato a d_min
+    const long long MIN_TAIL_VERTICES = 10;
+}
+
+DegreeDistribution::DegreeDistribution(std::vector<long long>&& histogram) : histogram(std::move(histogram)) {
+    finish();
+}
+
+void DegreeDistribution::finish() {
+    assert(!histogram.empty() && histogram.back() > 0);
+    int max = histogram.size() - 1;
+    at_least.assign(max + 2, 0);
+    degree_sum = 0;
+    for (int d = max; d >= 0; d--) {
+        at_least[d] = at_least[d + 1] + histogram[d];
+        degree_sum += histogram[d] * d;
+    }
+    assert(at_least[0] <= std::numeric_limits<int>::max());
+    n = at_least[0];
+    assert(n >= 1);
+}
+
+DegreeDistribution DegreeDistribution::from_degree_function(int n, const std::function<int(int)>& degree, int threads) {
+    assert(n >= 1);
+    threads = std::min(resolve_thread_count(threads), n);
+
+    // Cada thread conta os graus de uma faixa contígua de vértices no seu próprio histograma, que cresce conforme aparecem graus maiores
+    std::vector<std::vector<long long>> partial(threads);
+    run_in_threads(threads, [&](int tid) {
+        int begin = 1 + static_cast<long long>(n) * tid / threads;
+        int end = static_cast<long long>(n) * (tid + 1) / threads;
+        std::vector<long long>& local = partial[tid];
+        for (int v = begin; v <= end; v++) {
+            int d = degree(v);
+            assert(d >= 0);
+            if (d >= local.size()) local.resize(d + 1, 0);
+            local[d]++;
+        }
+    });
+
+    // Somar os histogramas - O(threads * grau máximo)
+    std::size_t size = 0;
+    for (const std::vector<long long>& local : partial) size = std::max(size, local.size());
+    std::vector<long long> histogram(size, 0);
+    for (const std::vector<long long>& local : partial) {
+        for (std::size_t d = 0; d < local.size(); d++) histogram[d] += local[d];
+    }
+    return DegreeDistribution(std::move(histogram));
+}
+
+DegreeDistribution DegreeDistribution::from_degrees(const std::vector<int>& degrees, int threads) {
+    assert(degrees.size() >= 2);
+    return from_degree_function(degrees.size() - 1, [&](int v) { return degrees[v]; }, threads);
+}
+
+int DegreeDistribution::degree_at(long long k) const {
+    assert(0 <= k && k < n);
+    // Menor d com mais de k vértices de grau <= d, ou seja, com at_least[d + 1] < n - k. at_least é não crescente
+    int low = 0;
+    int high = max_degree();
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (at_least[mid + 1] < n - k) high = mid;
+        else low = mid + 1;
+    }
+    return low;
+}
+
+int DegreeDistribution::min_degree() const {
+    return degree_at(0);
+}
+
+double DegreeDistribution::median() const {
+    if (n % 2 != 0) return degree_at(n / 2);
+    // Pegamos a média dos dois graus centrais
+    double sum = degree_at(n / 2 - 1) + degree_at(n / 2);
+    return sum / 2;
+}
+
+int DegreeDistribution::percentile(double p) const {
+    assert(0 <= p && p <= 100);
+    long long rank = static_cast<long long>(std::ceil(p / 100 * n));
+    if (rank < 1) rank = 1;
+    if (rank > n) rank = n;
+    return degree_at(rank - 1);
+}
+
+long long DegreeDistribution::count(int d) const {
+    assert(d >= 0);
+    return d <= max_degree() ? histogram[d] : 0;
+}
+
+double DegreeDistribution::ccdf(int d) const {
+    assert(d >= 0);
+    return d <= max_degree() ? static_cast<double>(at_least[d]) / n : 0.0;
+}
+
+PowerLawFit DegreeDistribution::power_law_fit(int threads) const {
+    PowerLawFit best = {std::numeric_limits<double>::quiet_NaN(), 0, 0, 0.0};
+
+    // Graus distintos positivos, em ordem crescente, e o log de cada um menos 1/2 (usado no modelo) - O(grau máximo)
+    std::vector<int> degrees;
+    for (int d = 1; d <= max_degree(); d++) {
+        if (histogram[d] > 0) degrees.push_back(d);
+    }
+    int D = degrees.size();
+    if (D == 0) return best;
+    std::vector<double> log_half(D);
+    for (int i = 0; i < D; i++) log_half[i] = std::log(degrees[i] - 0.5);
+
+    // log_sum[j] = soma de ln(d) sobre os vértices de grau >= degrees[j] - O(D)
+    std::vector<double> log_sum(D + 1, 0.0);
+    for (int j = D - 1; j >= 0; j--) {
+        log_sum[j] = log_sum[j + 1] + histogram[degrees[j]] * std::log(static_cast<double>(degrees[j]));
+    }
+
+    // Candidatos a d_min: graus com pelo menos MIN_TAIL_VERTICES vértices na cauda (ou só o menor grau positivo, se nenhum tiver)
+    int candidates = 0;
+    while (candidates < D && at_least[degrees[candidates]] >= MIN_TAIL_VERTICES) candidates++;
+    if (candidates == 0) candidates = 1;
+
+    threads = std::min(resolve_thread_count(threads), candidates);
+    std::vector<PowerLawFit> thread_best(threads, best);
+    run_in_threads(threads, [&](int tid) {
+        PowerLawFit& local = thread_best[tid];
+        // Candidatos intercalados entre as threads, porque os primeiros têm caudas maiores
+        for (int j = tid; j < candidates; j += threads) {
+            long long tail = at_least[degrees[j]];
+            double alpha = 1 + tail / (log_sum[j] - tail * log_half[j]);
+
+            // Distância KS entre a CCDF da cauda e a do modelo, ((d - 1/2)/(d_min - 1/2))^(1 - alpha), dos dois lados de cada degrau
+            double ks = 0;
+            for (int i = j; i < D; i++) {
+                int d = degrees[i];
+                double model = std::exp((1 - alpha) * (log_half[i] - log_half[j]));
+                double model_next = std::exp((1 - alpha) * (std::log(d + 0.5) - log_half[j]));
+                double empirical = static_cast<double>(at_least[d]) / tail;
+                double empirical_next = static_cast<double>(at_least[d + 1]) / tail;
+                ks = std::max(ks, std::max(std::abs(empirical - model), std::abs(empirical_next - model_next)));
+            }
+
+            if (local.tail_vertices == 0 || ks < local.ks_distance) local = {alpha, degrees[j], tail, ks};
+        }
+    });
+
+    // Em caso de empate, fica o menor d_min (que usa mais vértices)
+    for (const PowerLawFit& fit : thread_best) {
+        if (fit.tail_vertices == 0) continue;
+        if (best.tail_vertices == 0 || fit.ks_distance < best.ks_distance || (fit.ks_distance == best.ks_distance && fit.d_min < best.d_min)) {
+            best = fit;
+        }
+    }
+    return best;
+}
+
+void DegreeDistribution::write_csv(const std::string& filename) const {
+    std::FILE* file = std::fopen(filename.c_str(), "w");
+    if (!file) throw std::runtime_error("Não foi possível criar o arquivo " + filename);
+
+    bool ok = std::fprintf(file, "grau,vertices,ccdf\n") > 0;
+    for (int d = 0; ok && d <= max_degree(); d++) {
+        if (histogram[d] == 0) continue;
+        ok = std::fprintf(file, "%d,%lld,%.10g\n", d, histogram[d], ccdf(d)) > 0;
+    }
+
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) throw std::runtime_error("Erro ao escrever o arquivo " + filename);
+}
+
+void DegreeDistribution::save(const std::string& filename, int threads) const {
+    std::vector<std::int64_t> pairs;
+    for (int d = 0; d <= max_degree(); d++) {
+        if (histogram[d] == 0) continue;
+        pairs.push_back(d);
+        pairs.push_back(histogram[d]);
+    }
+    PowerLawFit fit = power_law_fit(threads);
+
+    DDHeader header;
+    std::memcpy(header.magic, DD_MAGIC, sizeof(DD_MAGIC));
+    header.version = DD_VERSION;
+    header.flags = 0;
+    header.n = n;
+    header.degree_sum = degree_sum;
+    header.max_degree = max_degree();
+    header.distinct = pairs.size() / 2;
+    header.alpha = fit.alpha;
+    header.d_min = fit.d_min;
+    header.ks_distance = fit.ks_distance;
+
+    std::FILE* file = std::fopen(filename.c_str(), "wb");
+    if (!file) throw std::runtime_error("Não foi possível criar o arquivo " + filename);
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && std::fwrite(pairs.data(), sizeof(std::int64_t), pairs.size(), file) == pairs.size();
+
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) throw std::runtime_error("Erro ao escrever o arquivo " + filename);
+}
+
+DegreeDistribution DegreeDistribution::load(const std::string& filename) {
+    MappedFile file(filename);
+    const char* data = file.data();
+    std::size_t size = file.size();
+
+    DDHeader header;
+    if (size < sizeof(header)) throw std::runtime_error("Arquivo " + filename + " não é uma DegreeDistribution");
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, DD_MAGIC, sizeof(DD_MAGIC)) != 0 || header.version != DD_VERSION) {
+        throw std::runtime_error("Arquivo " + filename + " não é uma DegreeDistribution (ou é de outra versão)");
+    }
+    if (header.n < 1 || header.n > std::numeric_limits<int>::max() || header.max_degree < 0 || header.max_degree >= std::numeric_limits<int>::max() || header.distinct < 1) {
+        throw std::runtime_error("Arquivo " + filename + " tem um cabeçalho inválido");
+    }
+    if (size != sizeof(header) + header.distinct * 2 * sizeof(std::int64_t)) throw std::runtime_error("Arquivo " + filename + " está truncado ou corrompido");
+
+    std::vector<std::int64_t> pairs(header.distinct * 2);
+    std::memcpy(pairs.data(), data + sizeof(header), pairs.size() * sizeof(std::int64_t));
+
+    std::vector<long long> histogram(header.max_degree + 1, 0);
+    long long previous = -1;
+    for (std::size_t i = 0; i < pairs.size(); i += 2) {
+        std::int64_t d = pairs[i];
+        if (d <= previous || d > header.max_degree || pairs[i + 1] < 1) throw std::runtime_error("Arquivo " + filename + " está corrompido");
+        histogram[d] = pairs[i + 1];
+        previous = d;
+    }
+    if (previous != header.max_degree) throw std::runtime_error("Arquivo " + filename + " está corrompido");
+
+    DegreeDistribution result(std::move(histogram));
+    if (result.n != header.n || result.degree_sum != header.degree_sum) throw std::runtime_error("Arquivo " + filename + " está corrompido");
+    return result;
+}
@@ -0,0 +1,148 @@
+#ifndef DEGREE_DISTRIBUTION_H
+#define DEGREE_DISTRIBUTION_H
+
+#include <vector>
+#include <string>
+#include <functional>
+
+/**
+Ajuste de uma lei de potência P(grau = d) ~ d^(-alpha) à cauda d >= d_min da distribuição de graus, pelo método de Clauset, Shalizi e Newman: alpha é o estimador de máxima verossimilhança (na aproximação discreta) e d_min é o que minimiza a distância de Kolmogorov-Smirnov entre a cauda e o modelo.
+Se nenhum vértice tiver grau 1 ou mais, alpha é NaN e d_min é 0.
+*/
+struct PowerLawFit {
+    double alpha;
+    int d_min;
+    long long tail_vertices; // Quantidade de vértices com grau >= d_min
+    double ks_distance;
+};
+
+/**
+Distribuição dos graus de um grafo: histograma, CCDF, percentis e estatísticas resumidas, tudo calculado a partir do histograma (nenhuma lista de adjacências é copiada).
+Pode ser exportada como CSV (write_csv) ou em formato binário (save/load), para ser lida sem interpretar o texto de write_output.
+*/
+class DegreeDistribution {
+private:
+    int n = 0;
+    long long degree_sum = 0;
+    std::vector<long long> histogram; // histogram[d] = quantidade de vértices de grau d, para d de 0 até o grau máximo
+    std::vector<long long> at_least;  // at_least[d] = quantidade de vértices de grau >= d. Uma entrada a mais que histogram
+
+    // Calcula degree_sum e at_least a partir de histogram - O(grau máximo)
+    void finish();
+
+    // Retorna o grau na posição k (indexada em 0) dos graus em ordem crescente - O(log(grau máximo))
+    int degree_at(long long k) const;
+
+public:
+    /**
+    Recebe o histograma pronto: histogram[d] é a quantidade de vértices de grau d. Deve ter pelo menos um vértice, e a última entrada não pode ser 0.
+
+    O(grau máximo)
+    */
+    explicit DegreeDistribution(std::vector<long long>&& histogram);
+
+    /**
+    Monta a distribuição dos graus degree(1), ..., degree(n) em uma única passada. Os vértices são divididos em faixas contíguas entre as threads, e cada thread monta um histograma próprio; no fim, os histogramas são somados.
+    degree é chamada por várias threads ao mesmo tempo. threads é a quantidade de threads; 0 usa todos os núcleos da máquina.
+
+    O(n / threads + threads * grau máximo), mais o custo das chamadas de degree
+    */
+    static DegreeDistribution from_degree_function(int n, const std::function<int(int)>& degree, int threads = 0);
+
+    /**
+    Igual a from_degree_function, com os graus em um vetor com n + 1 entradas (a entrada 0 é ignorada).
+    */
+    static DegreeDistribution from_degrees(const std::vector<int>& degrees, int threads = 0);
+
+    int get_n() const {
+        return n;
+    }
+
+    /**
+    Retorna a quantidade de arestas (soma dos graus dividida por 2).
+
+    O(1)
+    */
+    long long edges() const {
+        return degree_sum / 2;
+    }
+
+    int min_degree() const;
+
+    int max_degree() const {
+        return static_cast<int>(histogram.size()) - 1;
+    }
+
+    double mean() const {
+        return static_cast<double>(degree_sum) / n;
+    }
+
+    /**
+    Retorna a mediana dos graus (com n par, a média dos dois graus centrais).
+
+    O(log(grau máximo))
+    */
+    double median() const;
+
+    /**
+    Retorna o percentil p (de 0 a 100) dos graus, pelo método do posto mais próximo: o menor grau d tal que pelo menos p% dos vértices têm grau <= d. percentile(0) é o grau mínimo e percentile(100) é o máximo.
+
+    O(log(grau máximo))
+    */
+    int percentile(double p) const;
+
+    /**
+    Retorna a quantidade de vértices de grau d (0 se d passar do grau máximo).
+
+    O(1)
+    */
+    long long count(int d) const;
+
+    /**
+    Retorna a CCDF em d: a fração dos vértices com grau >= d.
+
+    O(1)
+    */
+    double ccdf(int d) const;
+
+    /**
+    Retorna o histograma completo: get_histogram()[d] é a quantidade de vértices de grau d, para d de 0 até o grau máximo.
+
+    O(1)
+    */
+    const std::vector<long long>& get_histogram() const {
+        return histogram;
+    }
+
+    /**
+    Ajusta uma lei de potência à cauda da distribuição (ver PowerLawFit). Cada grau distinto é testado como d_min, e os candidatos são divididos entre as threads. Só são testados valores de d_min com pelo menos 10 vértices na cauda, se houver algum.
+    threads é a quantidade de threads; 0 usa todos os núcleos da máquina.
+
+    Seja D a quantidade de graus distintos (D <= grau máximo + 1 e D = O(sqrt(m))).
+    O(grau máximo + D^2 / threads)
+    */
+    PowerLawFit power_law_fit(int threads = 0) const;
+
+    /**
+    Escreve a distribuição em filename, em CSV com cabeçalho "grau,vertices,ccdf" e uma linha por grau que aparece no grafo, em ordem crescente. Lança std::runtime_error se não conseguir escrever.
+
+    O(grau máximo)
+    */
+    void write_csv(const std::string& filename) const;
+
+    /**
+    Salva a distribuição em filename, em formato binário (inteiros e doubles na ordem de bytes da máquina): um cabeçalho de 72 bytes com "GRAFODD\0", a versão, n, a soma dos graus, o grau máximo, a quantidade D de graus distintos e o ajuste de power_law_fit (alpha, d_min, distância KS), seguido de D pares int64 (grau, quantidade de vértices) em ordem crescente de grau. Lança std::runtime_error se não conseguir escrever.
+
+    O(grau máximo + custo de power_law_fit)
+    */
+    void save(const std::string& filename, int threads = 0) const;
+
+    /**
+    Carrega uma distribuição salva com save. Lança std::runtime_error se o arquivo não existir ou não for uma distribuição válida.
+
+    O(grau máximo)
+    */
+    static DegreeDistribution load(const std::string& filename);
+};
+
+#endif
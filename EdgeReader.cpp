@@ -0,0 +1,169 @@
+#include "EdgeReader.h"
+#include "Parallel.h"
+
+#include <cstdio>
+#include <charconv>
+#include <mutex>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+    // Tamanho dos blocos lidos do arquivo de uma vez. As arestas convertidas de um bloco ocupam cerca de duas vezes o tamanho do bloco, então ele não deve ser grande demais
+    const std::size_t BLOCK_SIZE = 8 << 20;
+
+    /**
+    Fecha o arquivo quando sair de escopo.
+    */
+    struct FileCloser {
+        void operator()(std::FILE* f) const {
+            std::fclose(f);
+        }
+    };
+
+    bool is_space(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    /**
+    Converte um número em [p, end), pulando espaços (mas não quebras de linha) antes dele. Retorna false se não houver número ali. Em caso de sucesso, p fica logo depois do número.
+
+    O(tamanho do número)
+    */
+    template <typename T>
+    bool parse_number(const char*& p, const char* end, T& value) {
+        while (p < end && is_space(*p)) p++;
+        std::from_chars_result r = std::from_chars(p, end, value);
+        if (r.ec != std::errc()) return false;
+        p = r.ptr;
+        return true;
+    }
+
+    /**
+    Converte todas as linhas em [p, end) e coloca as arestas em chunk. Linhas inválidas são ignoradas.
+
+    O(end - p)
+    */
+    void parse_lines(const char* p, const char* end, bool weighted, EdgeChunk& chunk) {
+        while (p < end) {
+            int u, v;
+            double w;
+            bool ok = parse_number(p, end, u) && parse_number(p, end, v) && (!weighted || parse_number(p, end, w));
+            if (ok) {
+                chunk.u.push_back(u);
+                chunk.v.push_back(v);
+                if (weighted) chunk.w.push_back(w);
+            }
+
+            // Ir para a próxima linha
+            while (p < end && *p != '\n') p++;
+            p++;
+        }
+    }
+
+    /**
+    Retorna a posição logo depois da primeira quebra de linha a partir de p (ou end, se não houver).
+
+    O(tamanho da linha)
+    */
+    const char* next_line(const char* p, const char* end) {
+        while (p < end && *p != '\n') p++;
+        return p < end ? p + 1 : end;
+    }
+}
+
+int read_vertex_count(const std::string& filename) {
+    std::unique_ptr<std::FILE, FileCloser> file(std::fopen(filename.c_str(), "rb"));
+    if (!file) throw std::runtime_error("Não foi possível abrir o arquivo " + filename);
+
+    char line[64];
+    std::size_t size = std::fread(line, 1, sizeof(line), file.get());
+    const char* p = line;
+    while (p < line + size && (is_space(*p) || *p == '\n')) p++;
+
+    int n;
+    if (!parse_number(p, line + size, n) || n < 1) throw std::runtime_error("Arquivo " + filename + " não começa com a quantidade de vértices");
+    return n;
+}
+
+int stream_edge_file(const std::string& filename, bool weighted, int threads, const std::function<void(int, const EdgeChunk&)>& consume) {
+    std::unique_ptr<std::FILE, FileCloser> file(std::fopen(filename.c_str(), "rb"));
+    if (!file) throw std::runtime_error("Não foi possível abrir o arquivo " + filename);
+
+    threads = resolve_thread_count(threads);
+    std::vector<EdgeChunk> chunks(threads);
+    // Arquivos pequenos cabem num bloco só, e não precisam de um buffer do tamanho do bloco
+    std::fseek(file.get(), 0, SEEK_END);
+    long file_size = std::ftell(file.get());
+    std::fseek(file.get(), 0, SEEK_SET);
+    std::size_t buffer_size = BLOCK_SIZE;
+    if (0 <= file_size && static_cast<std::size_t>(file_size) < BLOCK_SIZE) buffer_size = file_size + 1;
+    std::vector<char> buffer(buffer_size);
+    std::size_t carry = 0; // Bytes de uma linha incompleta do bloco anterior, já no início do buffer
+    bool first_block = true;
+    int n = 0;
+
+    while (true) {
+        std::size_t read = std::fread(buffer.data() + carry, 1, buffer.size() - carry, file.get());
+        std::size_t size = carry + read;
+        bool last_block = read < buffer.size() - carry;
+        if (size == 0) break;
+
+        const char* begin = buffer.data();
+        const char* end = begin + size;
+
+        // Só converter até a última quebra de linha. O resto vai para o próximo bloco
+        const char* complete = end;
+        if (!last_block) {
+            while (complete > begin && complete[-1] != '\n') complete--;
+            if (complete == begin) {
+                // Uma linha maior que o buffer: aumentar o buffer e tentar de novo
+                carry = size;
+                buffer.resize(buffer.size() * 2);
+                continue;
+            }
+        }
+
+        if (first_block) {
+            if (!parse_number(begin, complete, n) || n < 1) throw std::runtime_error("Arquivo " + filename + " não começa com a quantidade de vértices");
+            begin = next_line(begin, complete);
+            first_block = false;
+        }
+
+        // Dividir [begin, complete) entre as threads, sempre em quebras de linha
+        std::vector<const char*> bounds(threads + 1);
+        bounds[0] = begin;
+        for (int t = 1; t < threads; t++) {
+            const char* p = begin + (complete - begin) * t / threads;
+            if (p < bounds[t - 1]) p = bounds[t - 1];
+            bounds[t] = (p == begin) ? p : next_line(p - 1, complete);
+        }
+        bounds[threads] = complete;
+
+        run_in_threads(threads, [&](int tid) {
+            EdgeChunk& chunk = chunks[tid];
+            chunk.clear();
+            parse_lines(bounds[tid], bounds[tid + 1], weighted, chunk);
+            if (chunk.size() > 0) consume(tid, chunk);
+        });
+
+        if (last_block) break;
+
+        // Levar a linha incompleta para o início do buffer
+        carry = end - complete;
+        std::copy(complete, end, buffer.begin());
+    }
+
+    if (first_block) throw std::runtime_error("Arquivo " + filename + " está vazio");
+    return n;
+}
+
+void read_edge_list(const std::string& filename, int threads, int& n, std::vector<std::pair<int, int>>& edges) {
+    std::mutex m;
+    edges.resize(0);
+    n = stream_edge_file(filename, false, threads, [&](int tid, const EdgeChunk& chunk) {
+        std::lock_guard<std::mutex> lock(m);
+        for (int i = 0; i < chunk.size(); i++) {
+            edges.push_back(std::make_pair(chunk.u[i], chunk.v[i]));
+        }
+    });
+}
@@ -0,0 +1,54 @@
+#ifndef EDGE_READER_H
+#define EDGE_READER_H
+
+#include <vector>
+#include <string>
+#include <functional>
+
+/**
+Arestas lidas por uma thread em um pedaço do arquivo. As três listas são paralelas: a i-ésima aresta é (u[i], v[i]) com peso w[i]. Em arquivos sem peso, w fica vazio.
+*/
+struct EdgeChunk {
+    std::vector<int> u;
+    std::vector<int> v;
+    std::vector<double> w;
+
+    void clear() {
+        u.clear();
+        v.clear();
+        w.clear();
+    }
+
+    int size() const {
+        return u.size();
+    }
+};
+
+/**
+Lê só a primeira linha do arquivo de grafo filename e retorna n, a quantidade de vértices. Útil para alocar estruturas antes de stream_edge_file. Lança std::runtime_error se o arquivo não puder ser aberto ou se n não for pelo menos 1.
+
+O(1)
+*/
+int read_vertex_count(const std::string& filename);
+
+/**
+Lê o arquivo de grafo filename (primeira linha com n, depois uma aresta "u v" ou "u v peso" por linha) e retorna n.
+O arquivo é lido em blocos de 8 MB com fread (sem ifstream nem extração formatada). Cada bloco é dividido entre as threads em quebras de linha, e cada thread converte seu pedaço com std::from_chars para um EdgeChunk próprio e chama consume(tid, chunk). consume é chamada por várias threads ao mesmo tempo, e a ordem das arestas entre chamadas diferentes não é a do arquivo. O chunk só é válido durante a chamada.
+Linhas que não começam com uma aresta válida são ignoradas. Lança std::runtime_error se o arquivo não puder ser aberto ou se n não for pelo menos 1.
+
+threads é a quantidade de threads; 0 usa todos os núcleos da máquina.
+
+O(tamanho do arquivo / threads) para converter, mais o custo de consume
+*/
+int stream_edge_file(const std::string& filename, bool weighted, int threads, const std::function<void(int, const EdgeChunk&)>& consume);
+
+/**
+Lê o arquivo filename (sem pesos) com stream_edge_file e altera n e edges com as informações do arquivo. A ordem das arestas em edges pode ser diferente da do arquivo.
+
+threads é a quantidade de threads; 0 usa todos os núcleos da máquina.
+
+O(n + m)
+*/
+void read_edge_list(const std::string& filename, int threads, int& n, std::vector<std::pair<int, int>>& edges);
+
+#endif
@@ -1,5 +1,10 @@
 #include "Graph.h"
-#include <fstream>
+#include "Parallel.h"
+#include "EdgeReader.h"
+#include "MappedFile.h"
+#include "PriorityQueues.h"
+#include "UnionFind.h"
+#include "OutputWriter.h"
 #include <iostream>
 #include <algorithm>
 #include <queue>
@@ -7,15 +12,58 @@
 #include <functional>
 #include <cassert>
 #include <limits>
+#include <cmath>
+#include <cstdlib>
+#include <atomic>
+#include <mutex>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <exception>
 
 // Funções ajudantes
 namespace{
     /**
-    Retorna true <-> a.size() >= b.size().
+    Retorna true <-> a.size() > b.size(). Tem que ser estrita: com >=, std::sort pode sair do vetor quando há muitas componentes de mesmo tamanho.
     O(1)
     */
-    bool sort_key(const std::vector<int>& a, const std::vector<int> b) {
-        return a.size() >= b.size();
+    bool sort_key(const std::vector<int>& a, const std::vector<int>& b) {
+        return a.size() > b.size();
+    }
+
+    /**
+    Recebe um vetor no formato de connected_component_vector e retorna as componentes no formato de connected_components_unsorted.
+
+    O(n)
+    */
+    std::vector<std::vector<int>> group_components(const std::vector<int>& components) {
+        int n = components.size() - 1;
+
+        // Calcular a componente conexa de maior índice (O(n))
+        int max = -1;
+        for (int i = 1; i <= n; i++) {
+            if (components[i] > max) max = components[i];
+        }
+
+        // Mudar a representação (O(n))
+        std::vector<std::vector<int>> result(max + 1, std::vector<int>()); // Essa lista é indexada em 0 mesmo, pois não é de vértices, e sim de componentes conexas
+        for (int i = 1; i <= n; i++) {
+            int c = components[i];
+            if (c != -1) {
+                result[c].push_back(i); // O(1) amortizado
+            }
+        }
+
+        return result;
+    }
+
+    /**
+    Ordena as componentes em ordem decrescente de tamanho. A ordenação é estável, então componentes de mesmo tamanho mantêm a ordem em que estavam.
+
+    O(k log k), sendo k a quantidade de componentes
+    */
+    void sort_components(std::vector<std::vector<int>>& components) {
+        std::stable_sort(components.begin(), components.end(), sort_key);
     }
 
     /**
@@ -23,81 +71,319 @@ namespace{
 
     O(writee.size())
     */
-    void write_vector(std::ofstream& outfile, const std::vector<int>& writee) {
+    void write_vector(BufferedWriter& outfile, const std::vector<int>& writee) {
         for (int i = 0; i < writee.size(); i++) {
-            outfile << writee[i] << " ";
+            outfile << writee[i] << ' ';
+        }
+    }
+
+    // Formatos binários de write_bfs/write_dfs e de write_output (ver a documentação desses métodos em Graph.h)
+    const char TRAVERSAL_MAGIC[8] = {'G', 'R', 'A', 'F', 'O', 'T', 'R', 'V'};
+    const char REPORT_MAGIC[8] = {'G', 'R', 'A', 'F', 'O', 'R', 'E', 'L'};
+    const std::uint32_t OUTPUT_VERSION = 1;
+    const std::uint32_t TRAVERSAL_IS_DFS = 1;
+
+    struct TraversalHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t flags;
+        std::int64_t n;
+        std::int64_t source;
+    };
+    static_assert(sizeof(TraversalHeader) == 32, "O cabeçalho da busca deve ter 32 bytes, sem preenchimento");
+
+    struct ReportHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t flags;
+        std::int64_t n;
+        std::int64_t edges;
+        std::int64_t degree_min;
+        std::int64_t degree_max;
+        double degree_avg;
+        double degree_median;
+        std::int64_t components;
+    };
+    static_assert(sizeof(ReportHeader) == 72, "O cabeçalho do relatório deve ter 72 bytes, sem preenchimento");
+
+    /**
+    Escreve o resultado de uma busca a partir de s em filename. Em texto, title é a primeira linha, seguida de uma linha por vértice; em binário, o cabeçalho e os vetores parents e levels inteiros.
+
+    O(n)
+    */
+    void write_traversal(const std::string& filename, OutputFormat format, const char* title, std::uint32_t flags, int s, const std::vector<int>& parents, const std::vector<int>& levels) {
+        int n = parents.size() - 1;
+        BufferedWriter outfile(filename, format);
+
+        if (format == OutputFormat::BINARY) {
+            TraversalHeader header;
+            std::memcpy(header.magic, TRAVERSAL_MAGIC, sizeof(TRAVERSAL_MAGIC));
+            header.version = OUTPUT_VERSION;
+            header.flags = flags;
+            header.n = n;
+            header.source = s;
+            outfile.write_raw(&header, sizeof(header));
+            outfile.write_array(parents.data(), parents.size());
+            outfile.write_array(levels.data(), levels.size());
+        }
+        else {
+            outfile << title << "\n";
+            outfile << "\n";
+            for (int v = 1; v <= n; v++) {
+                outfile << "Vértice " << v << ": pai " << parents[v] << " e nível " << levels[v] << "\n";
+            }
+        }
+
+        outfile.close();
+    }
+
+    /**
+    Escreve o relatório de write_output em filename: contagens de vértices e arestas, estatísticas dos graus e as componentes conexas.
+    components já deve estar na ordem de connected_components().
+
+    O(n)
+    */
+    void write_report(const std::string& filename, OutputFormat format, const DegreeDistribution& degrees, const std::vector<std::vector<int>>& components) {
+        int vertices = degrees.get_n();
+        long long edges = degrees.edges(); // Grafo sem direção
+        int degree_min = degrees.min_degree();
+        int degree_max = degrees.max_degree();
+        double degree_avg = degrees.mean();
+        double degree_median = degrees.median();
+
+        BufferedWriter outfile(filename, format);
+
+        if (format == OutputFormat::BINARY) {
+            ReportHeader header;
+            std::memcpy(header.magic, REPORT_MAGIC, sizeof(REPORT_MAGIC));
+            header.version = OUTPUT_VERSION;
+            header.flags = 0;
+            header.n = vertices;
+            header.edges = edges;
+            header.degree_min = degree_min;
+            header.degree_max = degree_max;
+            header.degree_avg = degree_avg;
+            header.degree_median = degree_median;
+            header.components = components.size();
+            outfile.write_raw(&header, sizeof(header));
+
+            // Colunas: tamanho de cada componente, e depois os membros de todas, na mesma ordem
+            std::vector<std::int32_t> sizes(components.size());
+            for (std::size_t i = 0; i < components.size(); i++) sizes[i] = components[i].size();
+            outfile.write_array(sizes.data(), sizes.size());
+            for (const std::vector<int>& component : components) {
+                outfile.write_array(component.data(), component.size());
+            }
+            outfile.close();
+            return;
+        }
+
+        outfile << "Vértices: " << vertices << "\n";
+        outfile << "Arestas: " << edges << "\n";
+        outfile << "Grau mínimo: " << degree_min << "\n";
+        outfile << "Grau máximo: " << degree_max << "\n";
+        outfile << "Grau médio: " << degree_avg << "\n";
+        outfile << "Mediana de grau: " << degree_median << "\n";
+
+        outfile << "\n";
+        outfile << "Quantidade de componentes conexas: " << components.size() << "\n";
+        // Imprimir componentes conexas
+        for (int i = 0; i < components.size(); i++) {
+            const std::vector<int>& component = components[i];
+
+            outfile << "Componente " << i << ": tamanho "<< component.size() << "; membros: ";
+            write_vector(outfile, component);
+            outfile << "\n";
         }
+
+        outfile.close();
     }
 
     /**
-    Lê o arquivo filename e altera n e edges com as informações do arquivo.
+    Lê o arquivo filename e altera n e edges com as informações do arquivo. Usa o leitor paralelo de EdgeReader.h com todos os núcleos.
 
     O(n + m)
     */
     void read_file_info(const std::string& filename, int& n, std::vector<std::pair<int, int>>& edges) {
-        std::ifstream infile(filename);
-        assert(infile);
-        
-        infile >> n;
-        assert(n >= 1);
+        read_edge_list(filename, 0, n, edges);
+    }
 
-        edges.resize(0);
-        int u, v;
-        while (infile >> u >> v) {
-            edges.push_back(std::make_pair(u, v));
+    /**
+    Lê o arquivo filename (representando um grafo com peso) em duas passadas e monta o grafo em vetores contíguos: as arestas saindo de u ficam em arcs[offsets[u]], ..., arcs[offsets[u + 1] - 1], em ordem crescente de vizinho, e targets[i] = arcs[i].target (a topologia sem pesos, para a representação).
+    Primeira passada: conta os graus (com contadores atômicos, pois o arquivo é lido em paralelo). Segunda passada: cada thread reserva atomicamente a próxima posição livre do trecho de u e escreve ali o vizinho e o peso. Por fim, cada trecho é ordenado no lugar (em paralelo).
+
+    O(n + m log m)
+    */
+    void build_weighted_csr(const std::string& filename, int& n, std::vector<long long>& offsets, std::vector<int>& targets, std::vector<WeightedArc>& arcs) {
+        n = read_vertex_count(filename);
+        int threads = resolve_thread_count(0);
+
+        // Primeira passada: graus - O(n + m)
+        std::vector<std::atomic<int>> counter(n + 1);
+        for (auto& c : counter) c.store(0, std::memory_order_relaxed);
+        stream_edge_file(filename, false, threads, [&](int tid, const EdgeChunk& chunk) {
+            for (int i = 0; i < chunk.size(); i++) {
+                counter[chunk.u[i]].fetch_add(1, std::memory_order_relaxed);
+                counter[chunk.v[i]].fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+
+        offsets.assign(n + 2, 0);
+        for (int v = 1; v <= n; v++) {
+            offsets[v + 1] = offsets[v] + counter[v].load(std::memory_order_relaxed);
+            counter[v].store(0, std::memory_order_relaxed); // Agora conta quantos vizinhos de v já foram colocados
         }
 
-        return;
+        // Segunda passada: cada aresta direto na posição final - O(m)
+        arcs.assign(offsets[n + 1], WeightedArc{0, 0});
+        stream_edge_file(filename, true, threads, [&](int tid, const EdgeChunk& chunk) {
+            for (int i = 0; i < chunk.size(); i++) {
+                int u = chunk.u[i];
+                int v = chunk.v[i];
+                weight_t w = static_cast<weight_t>(chunk.w[i]);
+                arcs[offsets[u] + counter[u].fetch_add(1, std::memory_order_relaxed)] = WeightedArc{v, w};
+                arcs[offsets[v] + counter[v].fetch_add(1, std::memory_order_relaxed)] = WeightedArc{u, w}; // grafo não direcionado
+            }
+        });
+
+        // Ordenar cada trecho no lugar, com base nos vértices - O(m log m)
+        run_in_threads(threads, [&](int tid) {
+            for (int u = 1 + tid; u <= n; u += threads) {
+                std::sort(arcs.begin() + offsets[u], arcs.begin() + offsets[u + 1], [](const WeightedArc& a, const WeightedArc& b) {
+                    return a.target < b.target;
+                });
+            }
+        });
+
+        // Topologia sem pesos - O(m)
+        targets.resize(arcs.size());
+        for (std::size_t i = 0; i < arcs.size(); i++) {
+            targets[i] = arcs[i].target;
+        }
     }
 
+    // Formato binário (ver Graph::save_binary)
+    const char BINARY_MAGIC[8] = {'G', 'R', 'A', 'F', 'O', 'B', 'I', 'N'};
+    const std::uint32_t BINARY_VERSION = 1;
+    const std::uint32_t BINARY_HAS_WEIGHTS = 1;
+
+    struct BinaryHeader {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t flags;
+        std::int64_t n;
+        std::int64_t arcs;
+    };
+    static_assert(sizeof(BinaryHeader) == 32, "O cabeçalho binário deve ter 32 bytes, sem preenchimento");
+    static_assert(sizeof(long long) == sizeof(std::int64_t), "offsets são lidos do arquivo como long long");
+
     /**
-    Lê o arquivo filename (representando um grafo com peso) e altera n e edges com as informações do arquivo.
+    Arredonda x para cima até um múltiplo de 8.
+    O(1)
+    */
+    std::size_t align8(std::size_t x) {
+        return (x + 7) / 8 * 8;
+    }
 
-    O(n + m)
+    /**
+    Escreve o grafo g no formato binário. Se arcs não for nulo, ele tem as 2m arestas com peso, na mesma ordem dos vizinhos (vértice a vértice, em ordem crescente de vizinho), e os pesos são escritos como double.
+
+    O(n + m) para representações contíguas
     */
-    void read_file_info_weighted(const std::string& filename, int& n, std::vector<std::pair<int, int>>& edges, std::vector<double>& weights) {
-        std::ifstream infile(filename);
-        assert(infile);
-        
-        infile >> n;
-        assert(n >= 1);
+    void write_binary_graph(const std::string& filename, const Graph& g, const WeightedArc* arcs) {
+        int n = g.get_n();
+
+        // Offsets - O(n + m)
+        std::vector<std::int64_t> offsets(n + 2, 0);
+        for (int v = 1; v <= n; v++) {
+            offsets[v + 1] = offsets[v] + g.degree(v);
+        }
 
-        edges.resize(0);
-        weights.resize(0);
-        int u, v;
-        double w;
-        while (infile >> u >> v >> w) {
-            edges.push_back(std::make_pair(u, v));
-            weights.push_back(w);
+        BinaryHeader header;
+        std::memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+        header.version = BINARY_VERSION;
+        header.flags = arcs ? BINARY_HAS_WEIGHTS : 0;
+        header.n = n;
+        header.arcs = offsets[n + 1];
+
+        std::FILE* file = std::fopen(filename.c_str(), "wb");
+        if (!file) throw std::runtime_error("Não foi possível criar o arquivo " + filename);
+
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+        ok = ok && std::fwrite(offsets.data(), sizeof(std::int64_t), offsets.size(), file) == offsets.size();
+
+        // Targets, vértice a vértice, sem montar uma cópia do grafo - O(n + m)
+        std::vector<int> row;
+        for (int v = 1; v <= n && ok; v++) {
+            NeighborView nb = g.neighbor_view(v);
+            row.assign(nb.begin(), nb.end());
+            ok = std::fwrite(row.data(), sizeof(int), row.size(), file) == row.size();
+        }
+        std::size_t padding = align8(header.arcs * sizeof(int)) - header.arcs * sizeof(int);
+        const char zeros[8] = {0};
+        ok = ok && std::fwrite(zeros, 1, padding, file) == padding;
+
+        if (arcs) {
+            // Separar os pesos das arestas, em blocos
+            std::vector<double> block;
+            for (std::int64_t i = 0; i < header.arcs && ok; i += 1 << 16) {
+                std::int64_t end = std::min<std::int64_t>(i + (1 << 16), header.arcs);
+                block.clear();
+                for (std::int64_t j = i; j < end; j++) block.push_back(arcs[j].weight);
+                ok = std::fwrite(block.data(), sizeof(double), block.size(), file) == block.size();
+            }
         }
 
-        return;
+        ok = (std::fclose(file) == 0) && ok;
+        if (!ok) throw std::runtime_error("Erro ao escrever o arquivo " + filename);
     }
 
     /**
-    Lê o arquivo filename (representando um grafo com peso) e escreve em temp_weights um vetor de adjacências com pares (v, weight), ordenados de acordo com v.
+    Arquivo binário mapeado em memória, com ponteiros para cada seção.
+    */
+    struct BinaryGraphFile {
+        std::shared_ptr<MappedFile> file;
+        int n;
+        const long long* offsets;
+        const int* targets;
+        const double* weights; // nullptr se o arquivo não tem pesos
+    };
 
-    O(n + m log m)
+    /**
+    Mapeia o arquivo binário filename e confere se ele é válido.
+
+    O(1)
     */
-    void build_weighted_adjacency_vector(const std::string& filename, int& n, std::vector<std::vector<std::pair<int, double>>>& w_adj_vector) {
-        std::ifstream infile(filename);
-        assert(infile);
-        
-        infile >> n;
-        assert(n >= 1);
-
-        w_adj_vector.assign(n + 1, std::vector<std::pair<int, double>>());
-        int u, v;
-        double w;
-        while (infile >> u >> v >> w) {
-            w_adj_vector[u].push_back(std::make_pair(v, w));
-            w_adj_vector[v].push_back(std::make_pair(u, w)); // grafo não direcionado
-        }
-
-        // Ordenar com base nos vértices (O(m log m))
-        for (int i = 1; i <= n; i++) {
-            std::sort(w_adj_vector[i].begin(), w_adj_vector[i].end()); // Ordenar com base no primeiro elemento do par (o vértice)
+    BinaryGraphFile map_binary_graph(const std::string& filename) {
+        BinaryGraphFile result;
+        result.file = std::make_shared<MappedFile>(filename);
+        const char* data = result.file->data();
+        std::size_t size = result.file->size();
+
+        BinaryHeader header;
+        if (size < sizeof(header)) throw std::runtime_error("Arquivo " + filename + " não é um grafo binário");
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0 || header.version != BINARY_VERSION) {
+            throw std::runtime_error("Arquivo " + filename + " não é um grafo binário (ou é de outra versão)");
         }
+        if (header.n < 1 || header.n > std::numeric_limits<int>::max() || header.arcs < 0) {
+            throw std::runtime_error("Arquivo " + filename + " tem um cabeçalho inválido");
+        }
+
+        std::size_t offsets_start = sizeof(header);
+        std::size_t targets_start = offsets_start + (header.n + 2) * sizeof(std::int64_t);
+        std::size_t weights_start = targets_start + align8(header.arcs * sizeof(int));
+        std::size_t expected = weights_start;
+        bool has_weights = header.flags & BINARY_HAS_WEIGHTS;
+        if (has_weights) expected += header.arcs * sizeof(double);
+        if (size != expected) throw std::runtime_error("Arquivo " + filename + " está truncado ou corrompido");
+
+        result.n = header.n;
+        result.offsets = reinterpret_cast<const long long*>(data + offsets_start);
+        result.targets = reinterpret_cast<const int*>(data + targets_start);
+        result.weights = has_weights ? reinterpret_cast<const double*>(data + weights_start) : nullptr;
+        if (result.offsets[header.n + 1] != header.arcs) throw std::runtime_error("Arquivo " + filename + " está corrompido");
+        return result;
     }
 
     /**
@@ -129,6 +415,18 @@ std::vector<int> Graph::neighbors(int v) const {
     return r->neighbors(v);
 }
 
+NeighborView Graph::neighbor_view(int v) const {
+    return r->neighbor_view(v);
+}
+
+int Graph::degree(int v) const {
+    return r->degree(v);
+}
+
+DegreeDistribution Graph::degree_distribution(int threads) const {
+    return DegreeDistribution::from_degree_function(get_n(), [this](int v) { return degree(v); }, threads);
+}
+
 int Graph::max_dist(const std::vector<int>& dists) const {
     assert(dists.size() > 0);
     for (int i = 0; i < dists.size(); i++) assert(dists[i] == -1 || 0 <= dists[i]);
@@ -142,8 +440,33 @@ int Graph::max_dist(const std::vector<int>& dists) const {
     return max;
 }
 
-std::vector<int> Graph::connected_component_vector() const {
+std::vector<int> Graph::connected_component_vector(ComponentsEngine engine, int threads) const {
     int n = get_n();
+
+    if (engine == ComponentsEngine::UNION_FIND) {
+        threads = resolve_thread_count(threads);
+        ConcurrentUnionFind uf(n);
+
+        // Cada thread pega blocos de vértices e une v a cada vizinho maior que ele, então cada aresta é vista uma vez
+        const int block = 1024;
+        std::atomic<int> next_block(1);
+        run_in_threads(threads, [&](int tid) {
+            while (true) {
+                int begin = next_block.fetch_add(block);
+                if (begin > n) break;
+                int end = std::min(n, begin + block - 1);
+                for (int v = begin; v <= end; v++) {
+                    for (int w : neighbor_view(v)) {
+                        if (w > v) uf.unite(v, w);
+                    }
+                }
+            }
+        });
+
+        // Como a raiz de cada conjunto é o seu menor vértice, a numeração é a mesma da BFS abaixo
+        return uf.labels();
+    }
+
     std::vector<int> result(n + 1, -1);
 
     int i = 1;
@@ -158,39 +481,41 @@ std::vector<int> Graph::connected_component_vector() const {
     return result;
 }
 
-std::vector<std::vector<int>> Graph::connected_components_unsorted() const {
-    int n = get_n();
-
+std::vector<std::vector<int>> Graph::connected_components_unsorted(ComponentsEngine engine, int threads) const {
     // Pegar as componentes conexas (O(n + m))
-    std::vector<int> components = connected_component_vector();
-
-    // Calcular a componente conexa de maior índice (O(n))
-    int max = -1;
-    for (int i = 1; i <= n; i++) {
-        if (components[i] > max) max = components[i];
-    }
+    std::vector<int> components = connected_component_vector(engine, threads);
 
     // Mudar a representação (O(n))
-    std::vector<std::vector<int>> result(max + 1, std::vector<int>()); // Essa lista é indexada em 0 mesmo, pois não é de vértices, e sim de componentes conexas
-    for (int i = 1; i <= n; i++) {
-        int c = components[i];
-        if (c != -1) {
-            result[c].push_back(i); // O(1) amortizado
-        }
-    }
+    return group_components(components);
+}
 
+int Graph::eccentricity(int v, std::vector<int>& levels, std::vector<int>& parents) const {
+    bfs(v, levels, parents);
+    int n = get_n();
+    int result = 0;
+    for (int w = 1; w <= n; w++) {
+        if (result < levels[w]) result = levels[w];
+    }
     return result;
 }
 
 // Métodos públicos
-Graph::Graph(const std::string& filename, bool use_matrix) {
+Graph::Graph(const std::string& filename, bool use_matrix)
+    : Graph(filename, use_matrix ? RepresentationType::ADJACENCY_MATRIX : RepresentationType::ADJACENCY_VECTOR) {}
+
+Graph::Graph(const std::string& filename, RepresentationType type) {
     int n;
     std::vector<std::pair<int, int>> edges;
     read_file_info(filename, n, edges);
-    if (use_matrix) {
-        r = std::make_unique<AdjacencyMatrix>(n, edges);
-    } else {
-        r = std::make_unique<AdjacencyVector>(n, edges);
+    switch (type) {
+        case RepresentationType::ADJACENCY_MATRIX:
+            r = std::make_unique<AdjacencyMatrix>(n, edges);
+            break;
+        case RepresentationType::CSR:
+            r = std::make_unique<CompressedSparseRow>(n, edges);
+            break;
+        default:
+            r = std::make_unique<AdjacencyVector>(n, edges);
     }
 }
 
@@ -198,72 +523,43 @@ void Graph::print() const {
     r->print();
 }
 
-void Graph::write_output(const std::string& filename) const {
-    int vertices = get_n();
-    int n = get_n();
-
-    // O(n + m) para vetores de adjacências, O(n^2) para matriz de adjacências
-    int edges = 0;
-    std::vector<int> degrees(n + 1, 0); // Vértice de índice 0 não existe
-    for (int i = 1; i <= n; i++) {
-        int degree = neighbors(i).size();
-        degrees[i] = degree;
-        edges += degree;
-    }
-    edges = edges/2; // Grafo sem direção
-
-    // Calcular coisas com os graus
-    int degree_sum = 0;
-    int degree_min = -1;
-    int degree_max = -1;
-    for (int i = 1; i <= n; i++) {
-        int degree = degrees[i];
-        degree_sum += degree;
-        
-        if (degree_min == -1 || degree < degree_min) {
-            degree_min = degree;;
-        }
-        if (degree_max == -1 || degree_max < degree) {
-            degree_max = degree;
-        }
-    }
-    double degree_avg = (static_cast<double>(degree_sum))/n;
-
-    std::vector<int> real_degrees(degrees.begin() + 1, degrees.end());
-    std::sort(real_degrees.begin(), real_degrees.end());
-    double degree_median; // Operação O(n log n)
-    if (n % 2 != 0) {
-        degree_median = real_degrees[n/2];
-    }
-    else {
-        // Pegamos a média dos dois graus centrais
-        double sum = real_degrees[n/2 - 1] + real_degrees[n/2];
-        degree_median = sum/2;
-    }
+void Graph::write_output(const std::string& filename, OutputFormat format) const {
+    // O(n) para vetores de adjacências e CSR, O(n^2/64) para matriz de adjacências
+    DegreeDistribution degrees = degree_distribution();
 
     // Calcular componentes conexas
     std::vector<std::vector<int>> components = connected_components();
 
-    std::ofstream outfile(filename);
-    assert(outfile);
-
-    outfile << "Vértices: " << vertices << "\n";
-    outfile << "Arestas: " << edges << "\n";
-    outfile << "Grau mínimo: " << degree_min << "\n";
-    outfile << "Grau máximo: " << degree_max << "\n";
-    outfile << "Grau médio: " << degree_avg << "\n";
-    outfile << "Mediana de grau: " << degree_median << "\n";
+    write_report(filename, format, degrees, components);
+}
 
-    outfile << "\n";
-    outfile << "Quantidade de componentes conexas: " << components.size() << "\n";
-    // Imprimir componentes conexas
-    for (int i = 0; i < components.size(); i++) {
-        std::vector<int> component = components[i];
+void Graph::write_output_from_file(const std::string& graph_file, const std::string& filename, int threads, OutputFormat format) {
+    int n = read_vertex_count(graph_file);
 
-        outfile << "Componente " << i << ": tamanho "<< component.size() << "; membros: ";
-        write_vector(outfile, component);
-        outfile << "\n";
+    // Uma passada pelo arquivo: cada thread soma os graus e une as pontas das arestas do seu pedaço (O(m log n) amortizado, dividido entre as threads)
+    std::vector<std::atomic<int>> shared_degrees(n + 1);
+    for (int i = 0; i <= n; i++) {
+        shared_degrees[i].store(0, std::memory_order_relaxed);
     }
+    ConcurrentUnionFind uf(n);
+    stream_edge_file(graph_file, false, threads, [&](int tid, const EdgeChunk& chunk) {
+        for (int i = 0; i < chunk.size(); i++) {
+            shared_degrees[chunk.u[i]].fetch_add(1, std::memory_order_relaxed);
+            shared_degrees[chunk.v[i]].fetch_add(1, std::memory_order_relaxed);
+            uf.unite(chunk.u[i], chunk.v[i]);
+        }
+    });
+
+    // O(n)
+    DegreeDistribution degrees = DegreeDistribution::from_degree_function(n, [&](int v) {
+        return shared_degrees[v].load(std::memory_order_relaxed);
+    }, threads);
+
+    // Mesma ordem de connected_components() (O(n + k log k))
+    std::vector<std::vector<int>> components = group_components(uf.labels());
+    sort_components(components);
+
+    write_report(filename, format, degrees, components);
 }
 
 void Graph::bfs(int s, std::vector<int>& levels, std::vector<int>& parents) const {
@@ -280,10 +576,8 @@ void Graph::bfs(int s, std::vector<int>& levels, std::vector<int>& parents) cons
     while (!Q.empty()) {
         int v = Q.front();
         Q.pop();
-        std::vector<int> nb = neighbors(v);
         int d = levels[v];
-        for (int i = 0; i < nb.size(); i++) {
-            int w = nb[i];
+        for (int w : neighbor_view(v)) {
             if (levels[w] == -1) {
                 levels[w] = d + 1;
                 parents[w] = v;
@@ -293,6 +587,174 @@ void Graph::bfs(int s, std::vector<int>& levels, std::vector<int>& parents) cons
     }
 }
 
+void Graph::bfs_direction_optimizing(int s, std::vector<int>& levels, std::vector<int>& parents) const {
+    int n = get_n();
+    assert(1 <= s && s <= n);
+
+    levels.assign(n + 1, -1);
+    parents.assign(n + 1, -1);
+
+    // Parâmetros da heurística de Beamer
+    const double alpha = 14;
+    const double beta = 24;
+
+    // Arestas (contadas pelos dois lados) que saem de vértices ainda não visitados - O(n)
+    long long edges_unexplored = 0;
+    for (int v = 1; v <= n; v++) {
+        edges_unexplored += degree(v);
+    }
+
+    // A fronteira fica em frontier quando estamos de cima para baixo, e em frontier_bits quando estamos de baixo para cima
+    int words = n / 64 + 1;
+    std::vector<int> frontier = {s};
+    std::vector<int> next;
+    std::vector<std::uint64_t> frontier_bits(words, 0);
+    std::vector<std::uint64_t> next_bits(words, 0);
+    bool bottom_up = false;
+
+    levels[s] = 0;
+    parents[s] = s;
+    long long frontier_size = 1;
+    long long previous_size = 0;
+    long long edges_frontier = degree(s);
+    edges_unexplored -= edges_frontier;
+
+    int d = 0;
+    while (frontier_size > 0) {
+        // Decidir a direção deste nível
+        if (!bottom_up && edges_frontier > edges_unexplored / alpha) {
+            std::fill(frontier_bits.begin(), frontier_bits.end(), 0);
+            for (int u : frontier) frontier_bits[u / 64] |= std::uint64_t(1) << (u % 64);
+            bottom_up = true;
+        }
+        else if (bottom_up && frontier_size < n / beta && frontier_size < previous_size) {
+            frontier.clear();
+            for (int i = 0; i < words; i++) {
+                for (std::uint64_t b = frontier_bits[i]; b != 0; b &= b - 1) {
+                    frontier.push_back(i * 64 + count_trailing_zeros(b));
+                }
+            }
+            bottom_up = false;
+        }
+
+        long long next_size = 0;
+        long long edges_next = 0;
+        if (!bottom_up) {
+            // De cima para baixo: cada vértice da fronteira descobre seus vizinhos não visitados
+            next.clear();
+            for (int u : frontier) {
+                for (int w : neighbor_view(u)) {
+                    if (levels[w] == -1) {
+                        levels[w] = d + 1;
+                        parents[w] = u;
+                        next.push_back(w);
+                        edges_next += degree(w);
+                    }
+                }
+            }
+            next_size = next.size();
+            std::swap(frontier, next);
+        }
+        else {
+            // De baixo para cima: cada vértice não visitado procura um vizinho na fronteira, e para no primeiro que achar
+            std::fill(next_bits.begin(), next_bits.end(), 0);
+            for (int v = 1; v <= n; v++) {
+                if (levels[v] != -1) continue;
+                NeighborView nb = neighbor_view(v);
+                for (int w : nb) {
+                    if ((frontier_bits[w / 64] >> (w % 64)) & 1) {
+                        levels[v] = d + 1;
+                        parents[v] = w;
+                        next_bits[v / 64] |= std::uint64_t(1) << (v % 64);
+                        next_size++;
+                        edges_next += nb.size();
+                        break;
+                    }
+                }
+            }
+            std::swap(frontier_bits, next_bits);
+        }
+
+        edges_unexplored -= edges_next;
+        edges_frontier = edges_next;
+        previous_size = frontier_size;
+        frontier_size = next_size;
+        d++;
+    }
+}
+
+void Graph::parallel_bfs(int s, std::vector<int>& levels, std::vector<int>& parents, int threads) const {
+    int n = get_n();
+    assert(1 <= s && s <= n);
+    threads = resolve_thread_count(threads);
+
+    levels.assign(n + 1, -1);
+    parents.assign(n + 1, -1);
+
+    // Mapa de bits de visitados. Quem consegue ligar o bit de w com fetch_or é o único que escreve levels[w] e parents[w]
+    int words = n / 64 + 1;
+    std::vector<std::atomic<std::uint64_t>> visited(words);
+    for (auto& word : visited) word.store(0, std::memory_order_relaxed);
+
+    // Fronteiras com capacidade n, para nunca precisar realocar durante a busca
+    std::vector<int> frontier(n);
+    std::vector<int> next(n);
+    int frontier_size = 1;
+    frontier[0] = s;
+    levels[s] = 0;
+    parents[s] = s;
+    visited[s / 64].fetch_or(std::uint64_t(1) << (s % 64));
+
+    std::vector<std::vector<int>> local_next(threads);
+    std::atomic<int> cursor(0);
+    Barrier barrier(threads);
+    const int chunk = 64; // Quantidade de vértices da fronteira que uma thread pega por vez
+
+    run_in_threads(threads, [&](int tid) {
+        std::vector<int>& mine = local_next[tid];
+        while (true) {
+            // Expandir a fronteira em pedaços, para equilibrar a carga entre as threads
+            mine.clear();
+            int begin;
+            while ((begin = cursor.fetch_add(chunk)) < frontier_size) {
+                int end = std::min(begin + chunk, frontier_size);
+                for (int i = begin; i < end; i++) {
+                    int u = frontier[i];
+                    int d = levels[u];
+                    for (int w : neighbor_view(u)) {
+                        std::atomic<std::uint64_t>& word = visited[w / 64];
+                        std::uint64_t bit = std::uint64_t(1) << (w % 64);
+                        if (word.load(std::memory_order_relaxed) & bit) continue;
+                        if (word.fetch_or(bit, std::memory_order_relaxed) & bit) continue; // Outra thread chegou antes
+
+                        levels[w] = d + 1;
+                        parents[w] = u;
+                        mine.push_back(w);
+                    }
+                }
+            }
+            barrier.wait();
+
+            // Copiar a fronteira local para a posição certa da próxima fronteira
+            int offset = 0;
+            for (int t = 0; t < tid; t++) offset += local_next[t].size();
+            std::copy(mine.begin(), mine.end(), next.begin() + offset);
+            barrier.wait();
+
+            if (tid == 0) {
+                int total = 0;
+                for (int t = 0; t < threads; t++) total += local_next[t].size();
+                std::swap(frontier, next);
+                frontier_size = total;
+                cursor.store(0);
+            }
+            barrier.wait();
+
+            if (frontier_size == 0) break;
+        }
+    });
+}
+
 void Graph::bfs_visited(int s, std::vector<int>& visited, int marker) const{
     int n = get_n();
     assert(visited.size() == n + 1);
@@ -303,9 +765,7 @@ void Graph::bfs_visited(int s, std::vector<int>& visited, int marker) const{
     while (!Q.empty()) {
         int v = Q.front();
         Q.pop();
-        std::vector<int> nb = neighbors(v);
-        for (int i = 0; i < nb.size(); i++) {
-            int w = nb[i];
+        for (int w : neighbor_view(v)) {
             if (visited[w] != marker) {
                 visited[w] = marker;
                 Q.push(w);
@@ -314,20 +774,12 @@ void Graph::bfs_visited(int s, std::vector<int>& visited, int marker) const{
     }
 }
 
-void Graph::write_bfs(int s, const std::string& filename) const {
+void Graph::write_bfs(int s, const std::string& filename, OutputFormat format) const {
     std::vector<int> dists;
     std::vector<int> parents;
     bfs(s, dists, parents);
 
-    std::ofstream outfile(filename);
-    assert(outfile);
-
-    outfile << "Nível -1 significa não descoberto. Nível 0 e pai iguai a si significa raiz da árvore geradora induzida" << "\n";
-    outfile << "\n";
-    int n = get_n();
-    for (int v = 1; v <= n; v++) {
-        outfile << "Vértice " << v << ": pai " << parents[v] << " e nível " << dists[v] << "\n";
-    }
+    write_traversal(filename, format, "Nível -1 significa não descoberto. Nível 0 e pai iguai a si significa raiz da árvore geradora induzida", 0, s, parents, dists);
 }
 
 void Graph::dfs(int s, std::vector<int>&levels, std::vector<int>& parents) const {
@@ -336,51 +788,94 @@ void Graph::dfs(int s, std::vector<int>&levels, std::vector<int>& parents) const
     levels.assign(n + 1, -1);
     parents.assign(n + 1, -1);
 
-    std::stack<std::pair<int, int>> P; // A primeira entrada do par é o vértice. A segunda é o cara que o empilhou
-    P.push(std::make_pair(s, s));
+    // Cada entrada da pilha é um vértice e o ponto em que paramos de percorrer os seus vizinhos.
+    // Isso é equivalente a empilhar todos os vizinhos em ordem contrária (mesma ordem de descoberta), mas sem copiar as listas de adjacências
+    struct Frame {
+        int u;
+        NeighborView::iterator it;
+        NeighborView::iterator end;
+    };
+
+    std::vector<Frame> P;
+    levels[s] = 0;
+    parents[s] = s;
+    NeighborView nb = neighbor_view(s);
+    P.push_back({s, nb.begin(), nb.end()});
     while (!P.empty()) {
-        std::pair<int, int> p = P.top();
-        P.pop();
-
-        int u = p.first;
-        int parent = p.second;
-        int l = levels[parent];
-        if (levels[u] == -1) {
-            levels[u] = l + 1;
-            parents[u] = parent;
-            std::vector<int> nb = neighbors(u);
-            for (int i = nb.size() - 1; 0 <= i; i--) { // Empilhamos em ordem contrária para descobrirmos na ordem certa
-                int v = nb[i];
-                P.push(std::make_pair(v, u));
-            }
+        Frame& f = P.back();
+        if (f.it == f.end) {
+            P.pop_back();
+            continue;
+        }
+
+        int u = f.u;
+        int v = *f.it;
+        ++f.it;
+        if (levels[v] == -1) {
+            levels[v] = levels[u] + 1;
+            parents[v] = u;
+            NeighborView nbv = neighbor_view(v);
+            P.push_back({v, nbv.begin(), nbv.end()}); // f pode ser invalidado aqui, mas não é mais usado
         }
     }
 }
 
-void Graph::write_dfs(int s, const std::string& filename) const {
+void Graph::write_dfs(int s, const std::string& filename, OutputFormat format) const {
     std::vector<int> levels;
     std::vector<int> parents;
     dfs(s, levels, parents);
 
-    std::ofstream outfile(filename);
-    assert(outfile);
-
-    outfile << "Nível -1 significa não descoberto. Nível 0 e pai igual a si significa raiz da árvore geradora induzida" << "\n";
-    outfile << "\n";
-    int n = get_n();
-    for (int v = 1; v <= n; v++) {
-        outfile << "Vértice " << v << ": pai " << parents[v] << " e nível " << levels[v] << "\n";
-    }
+    write_traversal(filename, format, "Nível -1 significa não descoberto. Nível 0 e pai igual a si significa raiz da árvore geradora induzida", TRAVERSAL_IS_DFS, s, parents, levels);
 }
 
 int Graph::dist(int u, int v) const {
+    int touched;
+    return bidirectional_bfs(u, v, touched);
+}
+
+int Graph::bidirectional_bfs(int u, int v, int& touched) const {
     int n = get_n();
     assert(1 <= u && u <= n && 1 <= v && v <= n);
-    std::vector<int> dists;
-    std::vector<int> parents;
+    touched = 1;
+    if (u == v) return 0;
+
+    // seen[x] = nível de x + 1 na busca a partir de u, -(nível de x + 1) na busca a partir de v, ou 0 se nenhuma das duas chegou em x
+    std::vector<int> seen(n + 1, 0);
+    std::vector<int> frontier[2] = {{u}, {v}};
+    std::vector<int> next;
+    int depth[2] = {0, 0};
+    seen[u] = 1;
+    seen[v] = -1;
+    touched = 2;
+
+    while (!frontier[0].empty() && !frontier[1].empty()) {
+        int side = frontier[0].size() <= frontier[1].size() ? 0 : 1;
+        int sign = side == 0 ? 1 : -1;
+        int label = sign * (depth[side] + 2);
+
+        // Expandir o nível inteiro antes de parar: o primeiro encontro não é necessariamente o melhor
+        int best = -1;
+        next.clear();
+        for (int x : frontier[side]) {
+            for (int y : neighbor_view(x)) {
+                if (seen[y] == 0) {
+                    seen[y] = label;
+                    next.push_back(y);
+                    touched++;
+                }
+                else if ((seen[y] > 0) != (side == 0)) {
+                    // y já foi alcançado pela outra busca: caminho com depth[side] + 1 arestas até y, mais o nível de y na outra busca
+                    int length = depth[side] + 1 + (std::abs(seen[y]) - 1);
+                    if (best == -1 || length < best) best = length;
+                }
+            }
+        }
+        if (best != -1) return best;
 
-    bfs(u, dists, parents);
-    return dists[v];
+        std::swap(frontier[side], next);
+        depth[side]++;
+    }
+    return -1;
 }
 
 int Graph::diameter() const {
@@ -400,6 +895,73 @@ int Graph::diameter() const {
     return max;
 }
 
+int Graph::parallel_diameter(int threads) const {
+    int n = get_n();
+    threads = resolve_thread_count(threads);
+
+    // Se alguma BFS não alcança todos os vértices, o grafo é desconexo e diameter() retornaria -1. Basta uma BFS para saber - O(n + m)
+    std::vector<int> visited(n + 1, -1);
+    bfs_visited(1, visited, 0);
+    for (int v = 1; v <= n; v++) {
+        if (visited[v] == -1) return -1;
+    }
+
+    int batches = (n + 63) / 64;
+    std::atomic<int> next_batch(0);
+    std::vector<int> thread_max(threads, 0);
+
+    run_in_threads(threads, [&](int tid) {
+        // seen[v]: quais buscas do lote já alcançaram v. visit[v]: quais buscas têm v na fronteira atual. next[v]: idem, para a próxima fronteira
+        std::vector<std::uint64_t> seen(n + 1);
+        std::vector<std::uint64_t> visit(n + 1);
+        std::vector<std::uint64_t> next(n + 1);
+        int max = 0;
+
+        int batch;
+        while ((batch = next_batch.fetch_add(1)) < batches) {
+            int first = batch * 64 + 1;
+            int last = std::min(first + 63, n);
+
+            std::fill(seen.begin(), seen.end(), 0);
+            std::fill(visit.begin(), visit.end(), 0);
+            std::fill(next.begin(), next.end(), 0);
+            for (int s = first; s <= last; s++) {
+                std::uint64_t bit = std::uint64_t(1) << (s - first);
+                seen[s] |= bit;
+                visit[s] |= bit;
+            }
+
+            // Cada nível expande as 64 buscas de uma vez. Como o grafo é conexo, todas as buscas terminam juntas no nível da maior excentricidade do lote
+            int level = 0;
+            bool active = true;
+            while (active) {
+                active = false;
+                for (int v = 1; v <= n; v++) {
+                    std::uint64_t frontier = visit[v];
+                    if (frontier == 0) continue;
+                    for (int w : neighbor_view(v)) {
+                        std::uint64_t discovered = frontier & ~seen[w];
+                        if (discovered) {
+                            next[w] |= discovered;
+                            seen[w] |= discovered;
+                            active = true;
+                        }
+                    }
+                }
+                if (active) level++;
+                std::swap(visit, next);
+                std::fill(next.begin(), next.end(), 0);
+            }
+
+            if (max < level) max = level;
+        }
+
+        thread_max[tid] = max;
+    });
+
+    return *std::max_element(thread_max.begin(), thread_max.end());
+}
+
 int Graph::approx_diameter() const {
     std::vector<int> dists;
     std::vector<int> parents;
@@ -421,18 +983,106 @@ int Graph::approx_diameter() const {
     return max_dist(dists);
 }
 
-std::vector<std::vector<int>> Graph::connected_components() const {
+DiameterResult Graph::ifub_diameter() const {
+    DiameterResult result = {-1, "iFUB (raiz no meio da varredura dupla)", 0};
+    int n = get_n();
+    std::vector<int> levels;
+    std::vector<int> parents;
+
+    // Começar pelo vértice de maior grau - O(n)
+    int r = 1;
+    int max_degree = -1;
+    for (int v = 1; v <= n; v++) {
+        int d = degree(v);
+        if (max_degree < d) {
+            max_degree = d;
+            r = v;
+        }
+    }
+
+    // Primeira varredura: acha a, o vértice mais distante de r. Se alguém não foi alcançado, o grafo é desconexo
+    bfs(r, levels, parents);
+    result.bfs_calls++;
+    int a = r;
+    for (int v = 1; v <= n; v++) {
+        if (levels[v] == -1) return result;
+        if (levels[a] < levels[v]) a = v;
+    }
+
+    // Segunda varredura: acha b, o vértice mais distante de a. ecc(a) já é um limite inferior para o diâmetro
+    int lower = eccentricity(a, levels, parents);
+    result.bfs_calls++;
+    int b = a;
+    for (int v = 1; v <= n; v++) {
+        if (levels[b] < levels[v]) b = v;
+    }
+
+    // Raiz: o vértice do meio do caminho de a até b
+    int u = b;
+    for (int i = 0; i < levels[b] / 2; i++) {
+        u = parents[u];
+    }
+
+    // BFS a partir da raiz, separando os vértices por nível (fronteiras)
+    int ecc_u = eccentricity(u, levels, parents);
+    result.bfs_calls++;
+    if (lower < ecc_u) lower = ecc_u;
+
+    std::vector<std::vector<int>> fringes(ecc_u + 1);
+    for (int v = 1; v <= n; v++) {
+        fringes[levels[v]].push_back(v);
+    }
+
+    // Do nível mais distante para o mais próximo. Antes de examinar o nível i, o diâmetro é no máximo 2i
+    std::vector<int> ecc_levels;
+    std::vector<int> ecc_parents;
+    for (int i = ecc_u; i >= 1; i--) {
+        if (lower >= 2 * i) break;
+
+        for (int x : fringes[i]) {
+            int ecc_x = eccentricity(x, ecc_levels, ecc_parents);
+            result.bfs_calls++;
+            if (lower < ecc_x) lower = ecc_x;
+        }
+
+        // Quem está nos níveis < i tem excentricidade no máximo 2(i - 1)
+        if (lower > 2 * (i - 1)) break;
+    }
+
+    result.diameter = lower;
+    return result;
+}
+
+std::vector<std::vector<int>> Graph::connected_components(ComponentsEngine engine, int threads) const {
     // Pegar as componentes conexas (O(n + m))
-    std::vector<std::vector<int>> components = connected_components_unsorted();
+    std::vector<std::vector<int>> components = connected_components_unsorted(engine, threads);
 
     // Ordenar com base no tamanho (O(k log k) <= O(n log n)
-    std::sort(components.begin(), components.end(), sort_key);
+    sort_components(components);
+    return components;
+}
+
+std::vector<std::vector<int>> Graph::connected_components_from_file(const std::string& filename, int threads) {
+    // O union-find precisa de n antes da primeira aresta (O(1))
+    int n = read_vertex_count(filename);
+    ConcurrentUnionFind uf(n);
+
+    // Unir as pontas das arestas enquanto o arquivo é lido (O(m log n) amortizado, dividido entre as threads)
+    stream_edge_file(filename, false, threads, [&](int tid, const EdgeChunk& chunk) {
+        for (int i = 0; i < chunk.size(); i++) {
+            uf.unite(chunk.u[i], chunk.v[i]);
+        }
+    });
+
+    // Mudar a representação e ordenar (O(n + k log k))
+    std::vector<std::vector<int>> components = group_components(uf.labels());
+    sort_components(components);
     return components;
 }
 
-void Graph::connected_component_info(int& amount, int& size_largest, int& size_smallest) const {
+void Graph::connected_component_info(int& amount, int& size_largest, int& size_smallest, ComponentsEngine engine, int threads) const {
     // Pegar as componentes conexas (O(n + m))
-    std::vector<std::vector<int>> components = connected_components_unsorted();
+    std::vector<std::vector<int>> components = connected_components_unsorted(engine, threads);
 
     // Percorrer para pegar a informação (O(n))
     int max = -1;
@@ -483,90 +1133,182 @@ std::vector<int> Graph::reconstruct_path(const std::vector<int>& parents, int u)
     return reversed;
 }
 
+void Graph::save_binary(const std::string& filename) const {
+    write_binary_graph(filename, *this, nullptr);
+}
+
+Graph Graph::load_binary(const std::string& filename) {
+    BinaryGraphFile mapped = map_binary_graph(filename);
+
+    Graph g;
+    g.r = std::make_unique<CompressedSparseRow>(mapped.n, mapped.offsets, mapped.targets, mapped.file);
+    return g;
+}
+
 // Métodos de WeightedGraph
-WeightedGraph::WeightedGraph(const std::string& filename, bool use_matrix) {
+WeightedGraph::WeightedGraph(const std::string& filename, bool use_matrix)
+    : WeightedGraph(filename, use_matrix ? RepresentationType::ADJACENCY_MATRIX : RepresentationType::ADJACENCY_VECTOR) {}
+
+WeightedGraph::WeightedGraph(const std::string& filename, RepresentationType type) {
     std::cout << "Começando a construir o WeightedGraph\n";
 
     int n;
-    std::vector<std::vector<std::pair<int, double>>> temp_weights;
+    std::vector<long long> offsets;
+    std::vector<int> targets;
 
-    // O(n + m log m)
-    build_weighted_adjacency_vector(filename, n, temp_weights);
+    // O(n + m log m), sem cópias intermediárias
+    build_weighted_csr(filename, n, offsets, targets, arcs);
+    arc_offsets = offsets;
 
-    // Copiar os pesos na ordem correta (O(n + m))
-    weights.assign(n + 1, std::vector<double>());
-    std::vector<std::vector<int>> adj_vector(n + 1, std::vector<int>());
-    for (int i = 1; i <= n; i++) {
-        for (int j = 0; j < temp_weights[i].size(); j++) {
-            adj_vector[i].push_back(temp_weights[i][j].first);
-            weights[i].push_back(temp_weights[i][j].second);
+    if (type == RepresentationType::CSR) {
+        r = std::make_unique<CompressedSparseRow>(std::move(offsets), std::move(targets));
+    }
+    else {
+        // As outras representações são montadas a partir do CSR (O(n + m))
+        std::vector<std::vector<int>> adj_vector(n + 1, std::vector<int>());
+        for (int u = 1; u <= n; u++) {
+            adj_vector[u].assign(targets.begin() + offsets[u], targets.begin() + offsets[u + 1]);
         }
+        targets.clear();
+        targets.shrink_to_fit();
 
-        // Destruir a linha para liberar memória
-        temp_weights[i].clear();
-        temp_weights[i].shrink_to_fit();
-
-        if (i % 100'000 == 0) {
-            std::cout << "Destruiu a linha " << i << "/" << n << "\n";
+        if (type == RepresentationType::ADJACENCY_MATRIX) {
+            r = std::make_unique<AdjacencyMatrix>(std::move(adj_vector));
+        } else {
+            r = std::make_unique<AdjacencyVector>(std::move(adj_vector));
         }
     }
-    
-    if (!use_matrix) {
-        r = std::make_unique<AdjacencyVector>(std::move(adj_vector));
-    } else {
-        r = std::make_unique<AdjacencyMatrix>(std::move(adj_vector));
-    }
 
+    compute_weight_stats();
     std::cout << "Terminou de construir o WeightedGraph\n";
 }
 
+void WeightedGraph::compute_weight_stats() {
+    stats = WeightStats();
+    if (arcs.empty()) return;
+
+    stats.min_weight = std::numeric_limits<double>::infinity();
+    stats.max_weight = -std::numeric_limits<double>::infinity();
+    for (const WeightedArc& a : arcs) {
+        double w = a.weight;
+        if (w < 0) stats.has_negative = true;
+        if (std::signbit(w) || std::isnan(w)) stats.bits_ordered = false;
+        if (w != std::floor(w)) stats.all_integral = false; // NaN também não é inteiro
+        stats.min_weight = std::min(stats.min_weight, w);
+        stats.max_weight = std::max(stats.max_weight, w);
+    }
+}
+
 void WeightedGraph::print() const {
     int n = get_n();
     std::cout << "Vértices: " << n << "\n";
     std::cout << "Vetor de adjacências com pesos (internamente, pode ser vetor ou matriz):\n";
     for (int u = 1; u <= n; u++) {
-        std::vector<int> nb = neighbors(u);
         std::cout << u << ": ";
-        for (int i = 0; i < nb.size(); i++) {
-            int v = nb[i];
-            double weight = weights[u][i];
-            std::cout << "(" << v << " com peso " << weight << ") ";
+        for (const WeightedArc& a : weighted_neighbors(u)) {
+            std::cout << "(" << a.target << " com peso " << a.weight << ") ";
         }
         std::cout << "\n";
     }
 }
 
+WeightedNeighborView WeightedGraph::weighted_neighbors(int u) const {
+    assert(1 <= u && u <= get_n());
+    const WeightedArc* first = arcs.data();
+    return WeightedNeighborView(first + arc_offsets[u], first + arc_offsets[u + 1]);
+}
+
 void WeightedGraph::dijkstra(int s, std::vector<double>& dists, std::vector<int>& parents, bool use_vector_only) const {
+    dijkstra(s, dists, parents, use_vector_only ? DijkstraQueue::VECTOR_ONLY : DijkstraQueue::LAZY_HEAP);
+}
+
+void WeightedGraph::dijkstra(int s, std::vector<double>& dists, std::vector<int>& parents, DijkstraQueue queue) const {
+    DijkstraWorkspace workspace;
+    dijkstra(s, dists, parents, queue, workspace);
+}
+
+void WeightedGraph::dijkstra(int s, std::vector<double>& dists, std::vector<int>& parents, DijkstraQueue queue, DijkstraWorkspace& workspace) const {
     int n = get_n();
     assert(1 <= s && s <= n);
 
-    // Ver se há pesos negativos - O(n + m)
-    for (int u = 1; u <= n; u++) {
-        for (int i = 0; i < weights[u].size(); i++) {
-            double w = weights[u][i];
-            if (w < 0) throw std::runtime_error("Encontrou um peso negativo durante a execução do algoritmo de Dijkstra");
-        }
-    }
+    // Ver se há pesos negativos - O(1), pelas estatísticas calculadas na construção
+    if (stats.has_negative) throw std::runtime_error("Encontrou um peso negativo durante a execução do algoritmo de Dijkstra");
+
+    // A heap radix compara os bits das distâncias, o que só funciona se nenhum peso tiver o bit de sinal (-0.0) ou for NaN
+    if (queue == DijkstraQueue::AUTO) queue = DijkstraQueue::RADIX_HEAP;
+    if (queue == DijkstraQueue::RADIX_HEAP && !stats.bits_ordered) queue = DijkstraQueue::DARY_HEAP;
 
     // Inicialização (O(1))
     double inf = std::numeric_limits<double>::infinity();
-    std::vector<bool> explored(n + 1, false);
+    std::vector<bool>& explored = workspace.explored;
+    explored.assign(n + 1, false);
     dists.assign(n + 1, inf);
     dists[s] = 0;
     parents.assign(n + 1, -1);
 
     // Dists é atualizado no momento que o vértice entra na heap/ é encontrado por um vizinho. parents é atualizado no momento que o vértice é retirado da heap/ é explorado de vez.
 
+    // Usando heap 4-ária indexada - O(n log n + m log n)
+    // Cada vértice tem no máximo uma entrada na heap: achar um caminho melhor diminui a chave da entrada existente. Por isso parents é atualizado junto com dists, no relaxamento.
+    if (queue == DijkstraQueue::DARY_HEAP) {
+        IndexedDaryHeap<4>& H = workspace.dary_heap;
+        H.reset(n + 1); // O(n)
+        H.push_or_decrease(s, 0);
+        parents[s] = s;
+
+        while (!H.empty()) {
+            double du;
+            int u = H.pop(du); // O(n) remoções, O(log n) cada
+            explored[u] = true;
+
+            for (const WeightedArc& a : weighted_neighbors(u)) {
+                int v = a.target;
+                if (explored[v]) continue;
+                double ndist = du + a.weight;
+
+                if (ndist < dists[v]) {
+                    dists[v] = ndist;
+                    parents[v] = u;
+                    H.push_or_decrease(v, ndist); // O(m) inserções ou decrease-keys, O(log n) cada
+                }
+            }
+        }
+    }
+
+    // Usando heap radix - O(m + n log C)
+    // Assim como a heap preguiçosa, não tem decrease-key: um vértice pode sair mais de uma vez, e só a primeira conta. parents é atualizado no relaxamento, junto com dists, pois a comparação é estrita.
+    else if (queue == DijkstraQueue::RADIX_HEAP) {
+        RadixHeap& H = workspace.radix_heap;
+        H.reset();
+        H.push(s, 0);
+        parents[s] = s;
+
+        while (!H.empty()) {
+            double du;
+            int u = H.pop(du); // O(m) remoções
+            if (explored[u]) continue;
+            explored[u] = true;
+
+            for (const WeightedArc& a : weighted_neighbors(u)) {
+                int v = a.target;
+                if (explored[v]) continue;
+                double ndist = du + a.weight;
+
+                if (ndist < dists[v]) {
+                    dists[v] = ndist;
+                    parents[v] = u;
+                    H.push(v, ndist); // O(m) inserções, O(1) cada
+                }
+            }
+        }
+    }
+
     // Usando Heap - O(n + m log m) = O(n + m log n)
     // Repare: nesta implementação, o tamanho da Heap é O(m), e não O(n). Porém, O(log m) = O(log (n^2)) = O(2 log n) = O(log n)
-    if (!use_vector_only) {
+    else if (queue == DijkstraQueue::LAZY_HEAP) {
         // Mais inicialização (O(1))
-        // Heap mínima
-        std::priority_queue<
-            std::tuple<double, int, int>, // dist, vértice e quem encontrou
-            std::vector<std::tuple<double, int, int>>,
-            std::greater<std::tuple<double, int, int>>
-        > H;
+        // Heap mínima, com tuplas (dist, vértice, quem encontrou). Fica vazia ao fim de cada chamada
+        auto& H = workspace.lazy_heap;
 
         H.push(std::make_tuple(0, s, s)); // s se descobriu com distância 0
 
@@ -580,11 +1322,10 @@ void WeightedGraph::dijkstra(int s, std::vector<double>& dists, std::vector<int>
             if (!explored[u]) { // Entramos nesse if O(n) vezes, pois cada vértice é explorado no máximo 1 vez
                 explored[u] = true;
                 parents[u] = parent;
-                std::vector<int> nb = neighbors(u); // Em matriz de adjacências, essa operação é O(n), criando aqui um n^2 que torna a complexidade igual à sem Heap
-
-                for (int i = 0; i < nb.size(); i++) {
-                    int v = nb[i];
-                    double w = weights[u][i];
+                // As arestas de u estão contíguas em arcs, com o peso ao lado do vizinho
+                for (const WeightedArc& a : weighted_neighbors(u)) {
+                    int v = a.target;
+                    double w = a.weight;
                     double ndist = dists[u] + w;
 
                     if (dists[v] >= ndist) {
@@ -600,10 +1341,8 @@ void WeightedGraph::dijkstra(int s, std::vector<double>& dists, std::vector<int>
     // Usando vetor - O(n^2)
     else {
         // Mais inicialização - O(n)
-        std::vector<std::pair<double, int>> dist_parent(n + 1);
-        for (int i = 0; i < dist_parent.size(); i++) {
-            dist_parent[i] = std::make_pair(inf, -1);
-        }
+        std::vector<std::pair<double, int>>& dist_parent = workspace.dist_parent;
+        dist_parent.assign(n + 1, std::make_pair(inf, -1));
         dist_parent[s] = std::make_pair(0, s); // s se descobriu com distância 0
 
         while (true) {// O(n) iterações (no pior caso, até todos os vértices serem explorados)
@@ -614,11 +1353,9 @@ void WeightedGraph::dijkstra(int s, std::vector<double>& dists, std::vector<int>
             int parent = dist_parent[u].second;
             explored[u] = true;
             parents[u] = parent;
-            std::vector<int> nb = neighbors(u);
-
-            for (int i = 0; i < nb.size(); i++) {
-                int v = nb[i];
-                double w = weights[u][i];
+            for (const WeightedArc& a : weighted_neighbors(u)) {
+                int v = a.target;
+                double w = a.weight;
                 double ndist = dists[u] + w;
 
                 if (dists[v] >= ndist) {
@@ -632,12 +1369,301 @@ void WeightedGraph::dijkstra(int s, std::vector<double>& dists, std::vector<int>
     }
 }
 
+void WeightedGraph::dijkstra_batch(const std::vector<int>& sources, const std::function<void(int, int, const std::vector<double>&, const std::vector<int>&)>& consume, DijkstraQueue queue, int threads) const {
+    int count = sources.size();
+    threads = std::min(resolve_thread_count(threads), std::max(count, 1));
+
+    // Cada thread pega o próximo vértice de início do contador compartilhado, então quem termina antes já pega outro
+    std::atomic<int> cursor(0);
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    run_in_threads(threads, [&](int tid) {
+        std::vector<double> dists;
+        std::vector<int> parents;
+        DijkstraWorkspace workspace;
+
+        try {
+            int i;
+            while ((i = cursor.fetch_add(1)) < count) {
+                dijkstra(sources[i], dists, parents, queue, workspace);
+                consume(tid, sources[i], dists, parents);
+            }
+        } catch (...) {
+            // Uma exceção não pode escapar da thread. Guardar a primeira e fazer as outras threads pararem
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) error = std::current_exception();
+            cursor.store(count);
+        }
+    });
+
+    if (error) std::rethrow_exception(error);
+}
+
+void WeightedGraph::delta_stepping(int s, std::vector<double>& dists, std::vector<int>& parents, double delta, int threads) const {
+    int n = get_n();
+    assert(1 <= s && s <= n);
+    threads = resolve_thread_count(threads);
+
+    // Ver se há pesos negativos - O(1), pelas estatísticas calculadas na construção
+    if (stats.has_negative) throw std::runtime_error("Encontrou um peso negativo durante a execução do Δ-stepping");
+    double max_weight = stats.max_weight;
+
+    // Padrão: maior peso dividido pelo grau médio. Cada vértice tem, em média, cerca de uma aresta leve, e os baldes não ficam nem finos demais (muitas rodadas) nem largos demais (muitas relaxações repetidas)
+    if (delta <= 0 && !arcs.empty()) {
+        delta = max_weight / (static_cast<double>(arcs.size()) / n);
+        if (stats.all_integral) delta = std::max(1.0, std::round(delta));
+    }
+    if (delta <= 0) delta = 1; // Sem arestas, ou todos os pesos são 0
+
+    double inf = std::numeric_limits<double>::infinity();
+    dists.assign(n + 1, inf);
+    parents.assign(n + 1, -1);
+
+    // Toda distância provisória fica entre o início do balde atual e o fim dele mais max_weight. Então bastam num_buckets baldes, reaproveitados em círculo (o balde k fica na posição k % num_buckets)
+    long long num_buckets = static_cast<long long>(max_weight / delta) + 3;
+    auto bucket_of = [delta](double d) {
+        return static_cast<long long>(d / delta);
+    };
+
+    // Pedido de relaxamento: "dists[v] pode ser dist, vindo de parent"
+    struct Request {
+        int v;
+        int parent;
+        double dist;
+    };
+
+    // outbox[t][o]: pedidos da thread t para vértices da thread o
+    std::vector<std::vector<std::vector<Request>>> outbox(threads, std::vector<std::vector<Request>>(threads));
+    std::vector<std::vector<std::vector<int>>> buckets(threads, std::vector<std::vector<int>>(num_buckets));
+    std::vector<long long> expanded_in(n + 1, -1); // Última rodada em que o vértice foi expandido (evita expandir duplicatas)
+    std::vector<long long> settled_in(n + 1, -1); // Último balde em que o vértice entrou em settled
+    std::vector<char> has_frontier(threads);
+    std::vector<long long> next_bucket(threads);
+    const long long none = std::numeric_limits<long long>::max();
+
+    dists[s] = 0;
+    parents[s] = s;
+    buckets[s % threads][0].push_back(s);
+
+    Barrier barrier(threads);
+
+    run_in_threads(threads, [&](int tid) {
+        std::vector<std::vector<Request>>& mine = outbox[tid];
+        std::vector<std::vector<int>>& my_buckets = buckets[tid];
+        std::vector<int> frontier;
+        std::vector<int> settled; // Vértices tirados do balde atual, para relaxar as arestas pesadas no fim
+        long long round = 0;
+
+        // Aplica os pedidos enviados para esta thread. Só a dona escreve em dists e parents, e só com distância estritamente menor
+        auto apply_requests = [&]() {
+            for (int t = 0; t < threads; t++) {
+                for (const Request& r : outbox[t][tid]) {
+                    if (r.dist < dists[r.v]) {
+                        dists[r.v] = r.dist;
+                        parents[r.v] = r.parent;
+                        my_buckets[bucket_of(r.dist) % num_buckets].push_back(r.v);
+                    }
+                }
+                outbox[t][tid].clear();
+            }
+        };
+
+        long long k = 0;
+        while (true) {
+            settled.clear();
+
+            // Arestas leves: repetir até o balde k ficar vazio em todas as threads
+            while (true) {
+                round++;
+                frontier.clear();
+                std::vector<int>& bucket = my_buckets[k % num_buckets];
+                for (int u : bucket) {
+                    // Descartar entradas velhas (a distância diminuiu para outro balde) e duplicatas
+                    if (bucket_of(dists[u]) != k || expanded_in[u] == round) continue;
+                    expanded_in[u] = round;
+                    frontier.push_back(u);
+                    if (settled_in[u] != k) {
+                        settled_in[u] = k;
+                        settled.push_back(u);
+                    }
+                }
+                bucket.clear();
+                has_frontier[tid] = !frontier.empty();
+
+                for (int u : frontier) {
+                    double du = dists[u];
+                    for (const WeightedArc& a : weighted_neighbors(u)) {
+                        if (a.weight <= delta) mine[a.target % threads].push_back(Request{a.target, u, du + a.weight});
+                    }
+                }
+                barrier.wait();
+
+                bool any = false;
+                for (int t = 0; t < threads; t++) any = any || has_frontier[t];
+                if (!any) break;
+
+                apply_requests();
+                barrier.wait();
+            }
+
+            // Arestas pesadas, a partir das distâncias já definitivas do balde k
+            for (int u : settled) {
+                double du = dists[u];
+                for (const WeightedArc& a : weighted_neighbors(u)) {
+                    if (a.weight > delta) mine[a.target % threads].push_back(Request{a.target, u, du + a.weight});
+                }
+            }
+            barrier.wait();
+            apply_requests();
+            barrier.wait();
+
+            // Próximo balde não vazio, considerando todas as threads
+            next_bucket[tid] = none;
+            for (long long j = k + 1; j <= k + num_buckets; j++) {
+                if (!my_buckets[j % num_buckets].empty()) {
+                    next_bucket[tid] = j;
+                    break;
+                }
+            }
+            barrier.wait();
+
+            k = none;
+            for (int t = 0; t < threads; t++) k = std::min(k, next_bucket[t]);
+            barrier.wait(); // Ninguém altera next_bucket antes de todos lerem
+            if (k == none) break;
+        }
+    });
+}
+
 double WeightedGraph::dist_weighted(int u, int v) const{
+    return shortest_path(u, v).dist;
+}
+
+void PointToPointWorkspace::prepare(int n) {
+    if (static_cast<int>(dist[0].size()) == n + 1) return; // Já está pronto: a última consulta limpou o que alterou
+
+    double inf = std::numeric_limits<double>::infinity();
+    for (int side = 0; side < 2; side++) {
+        dist[side].assign(n + 1, inf);
+        parent[side].assign(n + 1, -1);
+        heap[side].reset(n + 1);
+    }
+    touched.clear();
+}
+
+void PointToPointWorkspace::touch(int v) {
+    double inf = std::numeric_limits<double>::infinity();
+    if (dist[0][v] == inf && dist[1][v] == inf) touched.push_back(v);
+}
+
+void PointToPointWorkspace::clear() {
+    double inf = std::numeric_limits<double>::infinity();
+    for (int v : touched) {
+        for (int side = 0; side < 2; side++) {
+            dist[side][v] = inf;
+            parent[side][v] = -1;
+        }
+    }
+    touched.clear();
+    heap[0].clear();
+    heap[1].clear();
+}
+
+PathQueryResult WeightedGraph::shortest_path(int u, int v) const {
+    PointToPointWorkspace workspace;
+    return shortest_path(u, v, workspace);
+}
+
+PathQueryResult WeightedGraph::shortest_path(int u, int v, PointToPointWorkspace& workspace) const {
     int n = get_n();
     assert(1 <= u && u <= n && 1 <= v && v <= n);
-    std::vector<double> dists;
-    std::vector<int> parents;
+    if (stats.has_negative) throw std::runtime_error("Encontrou um peso negativo durante a execução do algoritmo de Dijkstra");
 
-    dijkstra(u, dists, parents, false);
-    return dists[v];
-}
\ No newline at end of file
+    double inf = std::numeric_limits<double>::infinity();
+    PathQueryResult result;
+    result.dist = inf;
+
+    workspace.prepare(n);
+    std::vector<double>* dist = workspace.dist;
+    std::vector<int>* parent = workspace.parent;
+    IndexedDaryHeap<4>* H = workspace.heap;
+
+    // Lado 0: busca a partir de u. Lado 1: busca a partir de v (o grafo é não direcionado, então as arestas são as mesmas)
+    int roots[2] = {u, v};
+    for (int side = 0; side < 2; side++) {
+        workspace.touch(roots[side]);
+        dist[side][roots[side]] = 0;
+        parent[side][roots[side]] = roots[side];
+        H[side].push_or_decrease(roots[side], 0);
+    }
+
+    double best = u == v ? 0 : inf; // Menor dist[0][x] + dist[1][x] visto até agora
+    int meet = u == v ? u : -1;     // O x de best
+
+    // Critério de parada: quando a soma das menores chaves das duas heaps é >= best, nenhum caminho ainda não visto pode ser melhor
+    while (!H[0].empty() && !H[1].empty() && H[0].top_key() + H[1].top_key() < best) {
+        int side = H[0].size() <= H[1].size() ? 0 : 1;
+        int other = 1 - side;
+
+        double dx;
+        int x = H[side].pop(dx);
+        result.settled++;
+
+        for (const WeightedArc& a : weighted_neighbors(x)) {
+            int y = a.target;
+            double ndist = dx + a.weight;
+
+            if (ndist < dist[side][y]) {
+                workspace.touch(y);
+                dist[side][y] = ndist;
+                parent[side][y] = x;
+                H[side].push_or_decrease(y, ndist);
+            }
+            // A outra busca já chegou em y: caminho u ... x - y ... v
+            if (dist[other][y] != inf && ndist + dist[other][y] < best) {
+                best = ndist + dist[other][y];
+                meet = y;
+            }
+        }
+    }
+
+    if (meet != -1) {
+        result.dist = best;
+
+        // De meet até u pelos pais da busca 0 (ao contrário), depois de meet até v pelos pais da busca 1
+        for (int x = meet; x != u; x = parent[0][x]) result.path.push_back(x);
+        result.path.push_back(u);
+        std::reverse(result.path.begin(), result.path.end());
+        for (int x = meet; x != v; ) {
+            x = parent[1][x];
+            result.path.push_back(x);
+        }
+    }
+
+    workspace.clear();
+    return result;
+}
+
+void WeightedGraph::save_binary(const std::string& filename) const {
+    write_binary_graph(filename, *this, arcs.data());
+}
+
+WeightedGraph WeightedGraph::load_binary(const std::string& filename) {
+    BinaryGraphFile mapped = map_binary_graph(filename);
+    if (!mapped.weights) throw std::runtime_error("Arquivo " + filename + " não tem pesos");
+
+    WeightedGraph wg;
+    wg.r = std::make_unique<CompressedSparseRow>(mapped.n, mapped.offsets, mapped.targets, mapped.file);
+
+    // Intercalar vizinhos e pesos na estrutura usada pelo Dijkstra - O(n + m)
+    int n = mapped.n;
+    long long arc_count = mapped.offsets[n + 1];
+    wg.arc_offsets.assign(mapped.offsets, mapped.offsets + n + 2);
+    wg.arcs.resize(arc_count);
+    for (long long i = 0; i < arc_count; i++) {
+        wg.arcs[i] = WeightedArc{mapped.targets[i], static_cast<weight_t>(mapped.weights[i])};
+    }
+    wg.compute_weight_stats();
+    return wg;
+}
@@ -2,10 +2,159 @@
 #define GRAPH_H
 
 #include "Representation.h"
+#include "PriorityQueues.h"
+#include "DegreeDistribution.h"
+#include "OutputWriter.h"
 #include <vector>
 #include <string>
 #include <memory>
 #include <stdexcept>
+#include <queue>
+#include <tuple>
+#include <functional>
+
+/**
+Representação interna escolhida na construção do grafo.
+    ADJACENCY_VECTOR: um std::vector<int> por vértice
+    ADJACENCY_MATRIX: matriz de adjacências
+    CSR: todas as listas de adjacências em um único par de vetores contíguos (offsets/targets)
+*/
+enum class RepresentationType {
+    ADJACENCY_VECTOR,
+    ADJACENCY_MATRIX,
+    CSR
+};
+
+/**
+Tipo usado para guardar os pesos em WeightedGraph. Por padrão é double. Compilando com -DGRAPH_FLOAT_WEIGHTS, passa a ser float: cada aresta ocupa 8 bytes em vez de 16, mais arestas cabem no cache, e as distâncias continuam sendo somadas em double (mas os pesos perdem precisão ao serem lidos).
+*/
+#ifdef GRAPH_FLOAT_WEIGHTS
+using weight_t = float;
+#else
+using weight_t = double;
+#endif
+
+/**
+Resultado de uma consulta de caminho mínimo entre dois vértices.
+*/
+struct PathQueryResult {
+    double dist;           // std::numeric_limits<double>::infinity() se não estiverem conectados
+    std::vector<int> path; // Da origem ao destino, incluindo ambos. Vazio se não estiverem conectados
+    int settled = 0;       // Quantidade de vértices explorados pela consulta (somando as buscas, se houver mais de uma)
+};
+
+/**
+Memória auxiliar das consultas entre dois vértices: distâncias e pais das duas buscas (a partir da origem e a partir do destino) e as heaps delas.
+Ao fim de cada consulta, só as posições que a consulta alterou são limpas, então uma consulta que explora poucos vértices custa pouco mesmo em um grafo grande. Não pode ser usado por duas threads ao mesmo tempo.
+*/
+struct PointToPointWorkspace {
+    std::vector<double> dist[2];
+    std::vector<int> parent[2];
+    IndexedDaryHeap<4> heap[2];
+    std::vector<int> touched; // Vértices com alguma distância diferente de infinito
+
+    // Deixa tudo pronto para um grafo com n vértices. Só aloca na primeira vez (ou se n mudar) - O(n) nesse caso, O(1) nos outros
+    void prepare(int n);
+
+    // Marca v como alterado, se ainda não estiver. Deve ser chamado antes de alterar dist[0][v] ou dist[1][v]
+    void touch(int v);
+
+    // Desfaz as alterações da última consulta - O(vértices alterados)
+    void clear();
+};
+
+/**
+Estrutura usada pelo algoritmo de Dijkstra para escolher o próximo vértice a explorar.
+    LAZY_HEAP: std::priority_queue sem decrease-key. Cada relaxamento insere uma entrada nova, e as velhas são descartadas ao sair. A heap chega a O(m) entradas
+    VECTOR_ONLY: procura o mínimo percorrendo o vetor de distâncias. O(n^2)
+    DARY_HEAP: heap 4-ária indexada com decrease-key. Cada vértice tem no máximo uma entrada, então a heap não passa de n entradas
+    RADIX_HEAP: heap radix sobre os bits das distâncias, sem comparações entre chaves. Só vale com pesos não negativos (sem -0.0 e sem NaN); caso contrário, usa DARY_HEAP
+    AUTO: escolhe a partir das estatísticas dos pesos do grafo (ver WeightStats): RADIX_HEAP quando vale, senão DARY_HEAP
+*/
+enum class DijkstraQueue {
+    LAZY_HEAP,
+    VECTOR_ONLY,
+    DARY_HEAP,
+    RADIX_HEAP,
+    AUTO
+};
+
+/**
+Algoritmo usado para encontrar as componentes conexas. Os dois dão exatamente o mesmo resultado.
+    BFS: uma BFS a partir de cada vértice ainda não visitado
+    UNION_FIND: union-find sem travas (ver UnionFind.h) unindo as pontas de cada aresta, com as arestas divididas entre threads. Não depende da ordem das arestas
+*/
+enum class ComponentsEngine {
+    BFS,
+    UNION_FIND
+};
+
+/**
+Memória auxiliar do algoritmo de Dijkstra: marcação de explorados e as filas de prioridade de cada DijkstraQueue. Passar o mesmo DijkstraWorkspace para várias chamadas reaproveita essa memória em vez de alocar tudo de novo. Não pode ser usado por duas threads ao mesmo tempo.
+*/
+struct DijkstraWorkspace {
+    std::vector<bool> explored;
+    std::vector<std::pair<double, int>> dist_parent; // VECTOR_ONLY: distância e quem encontrou
+    std::priority_queue<
+        std::tuple<double, int, int>, // LAZY_HEAP: dist, vértice e quem encontrou
+        std::vector<std::tuple<double, int, int>>,
+        std::greater<std::tuple<double, int, int>>
+    > lazy_heap;
+    IndexedDaryHeap<4> dary_heap;
+    RadixHeap radix_heap;
+};
+
+/**
+Uma aresta saindo de um vértice em WeightedGraph: o vizinho e o peso, lado a lado na memória.
+*/
+struct WeightedArc {
+    int target;
+    weight_t weight;
+};
+
+/**
+Estatísticas dos pesos de um WeightedGraph, calculadas uma vez na construção, para que os algoritmos não precisem percorrer todas as arestas a cada chamada.
+*/
+struct WeightStats {
+    bool has_negative = false; // Algum peso é < 0
+    bool bits_ordered = true;  // Nenhum peso é -0.0 ou NaN, então comparar os bits das distâncias é o mesmo que comparar os valores
+    bool all_integral = true;  // Todos os pesos são inteiros
+    double min_weight = 0;     // 0 se não houver arestas
+    double max_weight = 0;     // 0 se não houver arestas
+};
+
+/**
+Visão (sem cópia) das arestas saindo de um vértice de WeightedGraph, em ordem crescente de vizinho. Pode ser percorrida com for (const WeightedArc& a : view).
+*/
+class WeightedNeighborView {
+private:
+    const WeightedArc* first;
+    const WeightedArc* last;
+
+public:
+    WeightedNeighborView(const WeightedArc* first, const WeightedArc* last) : first(first), last(last) {}
+
+    const WeightedArc* begin() const {
+        return first;
+    }
+
+    const WeightedArc* end() const {
+        return last;
+    }
+
+    int size() const {
+        return last - first;
+    }
+};
+
+/**
+Resultado de um cálculo de diâmetro que também informa o algoritmo usado e quantas BFS foram feitas.
+*/
+struct DiameterResult {
+    int diameter;          // -1 caso o grafo não seja conexo
+    std::string algorithm;
+    int bfs_calls;
+};
 
 class Graph {
 protected:
@@ -15,7 +164,7 @@ protected:
     Graph() = default;
 
     /**
-    Retorna um vetor com os vizinhos do vértice v (de 1 a n), em ordem crescente. No caso de vetores de adjacências, é simplesmente uma cópia do vetor de adjacências correspondente a v.
+    Retorna um vetor com os vizinhos do vértice v (de 1 a n), em ordem crescente. No caso de vetores de adjacências, é simplesmente uma cópia do vetor de adjacências correspondente a v. Os algoritmos internos usam neighbor_view, que não copia nada.
     Vetores de adjacências: O(grau(v))
     Matriz de adjacências: O(n)
     */
@@ -32,20 +181,29 @@ private:
     int max_dist(const std::vector<int>& dists) const;
 
     /**
-    Retorna um vector<int> resultante com n + 1 entradas. A entrada 0 é -1. resultante[v] é a componente conexa do vértice v (a primeira componente conexa é 0, e assim por diante). Os índices das componentes conexas não seguem nenhuma ordem em particular.
+    Retorna um vector<int> resultante com n + 1 entradas. A entrada 0 é -1. resultante[v] é a componente conexa do vértice v (a primeira componente conexa é 0, e assim por diante). As componentes são numeradas na ordem do menor vértice de cada uma, com qualquer engine.
+    threads só é usado por ComponentsEngine::UNION_FIND; 0 usa todos os núcleos da máquina.
 
     Vetores de adjacências: O((n + m))
     Matriz de adjacências: O(n^2) 
     */
-    std::vector<int> connected_component_vector() const;
+    std::vector<int> connected_component_vector(ComponentsEngine engine = ComponentsEngine::BFS, int threads = 0) const;
 
     /**
-    Retorna um vector<vector<int>> resultante indexado em 0 mesmo. resultante[i] é um vector<int> com todos os vértices da i-ésima componente conexa. Os índices das componentes conexas não seguem nenhuma ordem em particular.
+    Retorna um vector<vector<int>> resultante indexado em 0 mesmo. resultante[i] é um vector<int> com todos os vértices da i-ésima componente conexa, em ordem crescente. As componentes seguem a ordem do menor vértice de cada uma.
     
     Vetores de adjacências: O(n + m)
     Matriz de adjacências: O(n^2)
     */
-    std::vector<std::vector<int>> connected_components_unsorted() const;
+    std::vector<std::vector<int>> connected_components_unsorted(ComponentsEngine engine = ComponentsEngine::BFS, int threads = 0) const;
+
+    /**
+    Roda a bfs a partir de v e retorna a excentricidade de v (a maior distância de v a outro vértice). levels e parents ficam com o resultado da bfs. O grafo deve ser conexo.
+
+    Vetores de adjacências: O(n + m)
+    Matriz de adjacências: O(n^2)
+    */
+    int eccentricity(int v, std::vector<int>& levels, std::vector<int>& parents) const;
 
 public:
     /**
@@ -56,6 +214,14 @@ public:
     */
     Graph(const std::string& filename, bool use_matrix);
 
+    /**
+    Igual ao construtor acima, mas permite escolher qualquer uma das representações (inclusive CSR).
+    Vetores de adjacências: O(n + m log m)
+    CSR: O(n + m log m)
+    Matriz de adjacências: O(n^2)
+    */
+    Graph(const std::string& filename, RepresentationType type);
+
     /**
     Imprime o grafo no console.
     Vetores de adjacências: O(n + m)
@@ -63,16 +229,58 @@ public:
     */
     virtual void print() const;
 
+    /**
+    Retorna uma visão dos vizinhos do vértice v (de 1 a n), em ordem crescente, sem copiar nem alocar nada. É o que os algoritmos internos usam para percorrer o grafo.
+    A visão é válida enquanto o grafo existir.
+    O(1) para obter a visão. Percorrê-la custa:
+    Vetores de adjacências e CSR: O(grau(v))
+    Matriz de adjacências: O(n/64 + grau(v))
+    */
+    NeighborView neighbor_view(int v) const;
+
+    /**
+    Retorna o grau do vértice v (de 1 a n), sem percorrer os vizinhos.
+    Vetores de adjacências e CSR: O(1)
+    Matriz de adjacências: O(n/64)
+    */
+    int degree(int v) const;
+
+    /**
+    Retorna a distribuição dos graus do grafo (histograma, CCDF, percentis, ajuste de lei de potência; ver DegreeDistribution), montada em uma passada paralela sobre degree(v), sem copiar listas de adjacências.
+    threads é a quantidade de threads; 0 usa todos os núcleos da máquina.
+
+    Vetores de adjacências e CSR: O(n / threads + threads * grau máximo)
+    Matriz de adjacências: O(n^2 / (64 threads) + threads * grau máximo)
+    */
+    DegreeDistribution degree_distribution(int threads = 0) const;
+
     /**
     Escreve um arquivo com informações sobre o grafo:
         Número de vértices
         Número de arestas
         Grau mínimo, máximo, médio, mediano
+    As estatísticas dos graus vêm de degree_distribution, sem ordenar os graus.
+    O arquivo é escrito com BufferedWriter. Em OutputFormat::BINARY, o formato (inteiros e doubles na ordem de bytes da máquina) é:
+        8 bytes "GRAFOREL", uint32 versão (1), uint32 flags (0), int64 n, int64 arestas, int64 grau mínimo, int64 grau máximo, double grau médio, double mediana de grau, int64 k (quantidade de componentes)
+        int32 tamanhos[k], na ordem das componentes do texto
+        int32 membros[n]: os membros de cada componente, uma depois da outra, na mesma ordem
+    Lança std::runtime_error se o arquivo não puder ser escrito.
     
-    Vetores de adjacências: O(n log(n) + m)
+    Seja k a quantidade de componentes conexas.
+    Vetores de adjacências: O(n + m + k log k)
     Matriz de adjacências: O(n^2)
     */
-    void write_output(const std::string& filename) const;
+    void write_output(const std::string& filename, OutputFormat format = OutputFormat::TEXT) const;
+
+    /**
+    Escreve em filename o mesmo relatório que write_output escreveria para o grafo do arquivo graph_file, mas sem construir o grafo: uma única passada por graph_file (com stream_edge_file) conta os graus e une as pontas das arestas em um union-find. Só usa O(n) de memória além do buffer de leitura, então serve para grafos cujas listas de adjacências não caberiam na memória.
+    Lança std::runtime_error se graph_file não puder ser aberto ou se n não for pelo menos 1.
+
+    threads é a quantidade de threads; 0 usa todos os núcleos da máquina.
+
+    O(tamanho do arquivo / threads + n log n)
+    */
+    static void write_output_from_file(const std::string& graph_file, const std::string& filename, int threads = 0, OutputFormat format = OutputFormat::TEXT);
 
     /**
     Altera os vetores dists e parents com informações acerca da bfs a partir do vértice s. No vetor dists, -1 significa "não visitado".
@@ -84,6 +292,28 @@ public:
     */
     void bfs(int s, std::vector<int>& levels, std::vector<int>& parents) const;
 
+    /**
+    BFS que otimiza a direção (Beamer): cada nível é expandido de cima para baixo (a partir da fronteira, como na bfs usual) ou de baixo para cima (cada vértice não visitado procura um vizinho na fronteira, que fica guardada como um mapa de bits). Troca para baixo para cima quando as arestas saindo da fronteira passam de 1/14 das arestas ainda não exploradas, e volta quando a fronteira fica menor que n/24 e está diminuindo.
+    Preenche levels e parents com o mesmo contrato de bfs: levels é idêntico, e parents é uma árvore de BFS válida (quando um vértice tem mais de um pai possível no nível anterior, o escolhido pode ser diferente do escolhido pela bfs).
+
+    s deve ser um vértice válido.
+
+    Vetores de adjacências e CSR: O(n + m) somando os níveis de cima para baixo, mais O(n + m) por nível de baixo para cima no pior caso (na prática, cada vértice para no primeiro vizinho da fronteira, e o total fica bem abaixo de m em grafos densos)
+    Matriz de adjacências: O(n^2) por nível
+    */
+    void bfs_direction_optimizing(int s, std::vector<int>& levels, std::vector<int>& parents) const;
+
+    /**
+    BFS em paralelo, nível a nível: as threads dividem a fronteira entre si, reivindicam cada vértice descoberto com uma operação atômica num mapa de bits de visitados, e guardam os descobertos numa fronteira local. No fim do nível, as fronteiras locais são concatenadas na próxima fronteira.
+    levels é sempre idêntico ao da bfs (o nível de um vértice não depende de qual thread o descobriu). parents é uma árvore de BFS válida, mas quando um vértice tem mais de um pai possível, o escolhido depende da ordem das threads.
+
+    threads é a quantidade de threads; 0 usa todos os núcleos da máquina. s deve ser um vértice válido.
+
+    Vetores de adjacências e CSR: O((n + m)/threads + profundidade) com boa distribuição
+    Matriz de adjacências: O(n^2/threads)
+    */
+    void parallel_bfs(int s, std::vector<int>& levels, std::vector<int>& parents, int threads = 0) const;
+
     /**
     Roda uma bfs, marcando no vetor visited os vértices visitados com o marcador marker.
     Diferentemente do que ocorre com a bfs usual, visited deve ter tamanho n + 1, e não será reinicializado. Assumimos que todos em visited são diferentes de marker quando o método é chamado.
@@ -95,10 +325,14 @@ public:
 
     /**
     Chama a bfs a partir de s e escreve um arquivo com as informações encontradas. Se filename tem um diretório, ele já deve existir (não será criado pelo método).
+    O arquivo é escrito com BufferedWriter. Em OutputFormat::BINARY, o formato (inteiros na ordem de bytes da máquina) é:
+        8 bytes "GRAFOTRV", uint32 versão (1), uint32 flags (bit 0: dfs; 0 para bfs), int64 n, int64 s
+        int32 pais[n + 1], int32 níveis[n + 1] (a entrada 0 de cada um é -1, como nos vetores de bfs)
+    Lança std::runtime_error se o arquivo não puder ser escrito.
     Vetores de adjacências: O(n + m)
     Matriz de adjacências: O(n^2) 
     */
-    void write_bfs(int s, const std::string& filename) const;
+    void write_bfs(int s, const std::string& filename, OutputFormat format = OutputFormat::TEXT) const;
 
     /**
     Altera os vetores dists e parents com informações acerca da dfs a partir do vértice s. No vetor levels, -1 significa "não visitado".
@@ -109,18 +343,32 @@ public:
 
     /**
     Chama a dfs a partir de s e escreve um arquivo com as informações encontradas. Se filename tem um diretório, ele já deve existir (não será criado pelo método).
+    Em OutputFormat::BINARY, o formato é o de write_bfs, com o bit 0 de flags ligado.
     Vetores de adjacências: O(n + m)
     Matriz de adjacências: O(n^2) 
     */
-    void write_dfs(int s, const std::string& filename) const;
+    void write_dfs(int s, const std::string& filename, OutputFormat format = OutputFormat::TEXT) const;
 
     /**
     Retorna a distância no grafo entre u e v. Caso não estejam conectados, retorna -1.
+    Usa bidirectional_bfs.
+
     Vetores de adjacências: O(n + m)
     Matriz de adjacências: O(n^2) 
     */
     virtual int dist(int u, int v) const;
 
+    /**
+    Retorna a distância no grafo entre u e v com BFS bidirecional: uma busca a partir de u e outra a partir de v, expandindo sempre a menor das duas fronteiras, nível por nível, até as buscas se encontrarem. Caso não estejam conectados, retorna -1.
+    Altera touched com a quantidade de vértices alcançados pelas duas buscas (uma BFS completa a partir de u alcançaria a componente inteira).
+
+    u e v devem ser vértices válidos.
+
+    Vetores de adjacências: O(n + m) no pior caso
+    Matriz de adjacências: O(n^2) no pior caso
+    */
+    int bidirectional_bfs(int u, int v, int& touched) const;
+
     /**
     Retorna o diâmetro exato do grafo. Retorna -1 caso o grafo não seja conexo.
     Vetores de adjacências: O(n(n + m))
@@ -128,6 +376,17 @@ public:
     */
     virtual int diameter() const;
 
+    /**
+    Retorna o diâmetro exato do grafo, com o mesmo resultado de diameter() (inclusive -1 caso o grafo não seja conexo), mas muito mais rápido.
+    Primeiro roda uma bfs para ver se o grafo é conexo. Depois, as fontes são agrupadas em lotes de 64, e cada lote é resolvido com uma única BFS de múltiplas fontes paralela em bits (MS-BFS): cada vértice guarda uma palavra de 64 bits dizendo quais das 64 buscas já o alcançaram, e cada aresta examinada serve às 64 buscas ao mesmo tempo. Os lotes são distribuídos entre as threads.
+
+    threads é a quantidade de threads; 0 usa todos os núcleos da máquina.
+
+    Vetores de adjacências e CSR: O(n(n + m)/(64 threads)) no caso típico
+    Matriz de adjacências: O(n^3/(64 threads))
+    */
+    virtual int parallel_diameter(int threads = 0) const;
+
     /**
     Retorna uma aproximação a do diâmetro d do grafo usando varredura dupla. Se o grafo é uma árvore, a = d. Se o grafo não for conexo, necessariamente retorna -1.
 
@@ -137,21 +396,43 @@ public:
     virtual int approx_diameter() const;
 
     /**
-    Retorna um vector<vector<int>> resultante indexado em 0 mesmo. resultante[i] é um vector<int> com todos os vértices da i-ésima componente conexa. Os índices das componentes seguem ordem decrescente de tamanho
+    Retorna o diâmetro exato do grafo usando iFUB (iterative Fringe Upper Bound), junto com o nome do algoritmo e a quantidade de BFS feitas. O diâmetro é igual ao de diameter(), inclusive -1 caso o grafo não seja conexo. Em WeightedGraph, os pesos são ignorados (distância em arestas).
+    Começa com a varredura dupla de approx_diameter (a partir do vértice de maior grau), e usa o vértice do meio do caminho encontrado como raiz u. Depois percorre os níveis da bfs a partir de u, do mais distante para o mais próximo, calculando a excentricidade de cada vértice do nível i. Um vértice num nível < i não pode ter excentricidade maior que 2(i - 1), então, assim que o maior valor encontrado passa disso, ele é o diâmetro.
+    Em grafos esparsos reais, costuma precisar de poucas BFS, em vez de n.
+
+    Vetores de adjacências: O(k(n + m)), sendo k a quantidade de BFS (no pior caso, k = n + 3)
+    Matriz de adjacências: O(k n^2)
+    */
+    DiameterResult ifub_diameter() const;
+
+    /**
+    Retorna um vector<vector<int>> resultante indexado em 0 mesmo. resultante[i] é um vector<int> com todos os vértices da i-ésima componente conexa. Os índices das componentes seguem ordem decrescente de tamanho; componentes de mesmo tamanho ficam na ordem do menor vértice de cada uma.
+    engine e threads escolhem o algoritmo (ver ComponentsEngine e connected_component_vector). O resultado não depende deles.
     
     Seja k a quantidade de componentes conexas.
     Vetores de adjacências: O(n + m + k log k) <= O(m + n log n) 
     Matriz de adjacências: O(n^2) 
     */
-    std::vector<std::vector<int>> connected_components() const;
+    std::vector<std::vector<int>> connected_components(ComponentsEngine engine = ComponentsEngine::BFS, int threads = 0) const;
 
     /**
     Altera amount, size_largest e size_smallest com informações sobre as componentes conexas.
+    engine e threads escolhem o algoritmo (ver ComponentsEngine e connected_component_vector). O resultado não depende deles.
 
     Vetores de adjacências: O(n + m)
     Matriz de adjacências: O(n^2) 
     */
-    void connected_component_info(int& amount, int& size_largest, int& size_smallest) const;
+    void connected_component_info(int& amount, int& size_largest, int& size_smallest, ComponentsEngine engine = ComponentsEngine::BFS, int threads = 0) const;
+
+    /**
+    Igual a connected_components, mas lendo as arestas direto do arquivo de grafo filename, sem construir o grafo: cada thread de stream_edge_file une as pontas das arestas do seu pedaço no union-find enquanto o arquivo é lido. Só usa O(n) de memória além do buffer de leitura.
+    Lança std::runtime_error se o arquivo não puder ser aberto ou se n não for pelo menos 1.
+
+    threads é a quantidade de threads; 0 usa todos os núcleos da máquina.
+
+    O(tamanho do arquivo / threads + n log n)
+    */
+    static std::vector<std::vector<int>> connected_components_from_file(const std::string& filename, int threads = 0);
 
     /**
     Retorna a quantidade de vértices do grafo.
@@ -167,25 +448,80 @@ public:
     O(n)
     */
     std::vector<int> reconstruct_path(const std::vector<int>& parents, int v) const;
+
+    /**
+    Salva o grafo no formato binário (pronto para load_binary), independentemente da representação interna. O formato, com inteiros na ordem de bytes da máquina, é:
+        8 bytes "GRAFOBIN", uint32 versão (1), uint32 flags (bit 0: tem pesos), int64 n, int64 arcs (= 2m)
+        int64 offsets[n + 2] (os vizinhos de v são targets[offsets[v]], ..., targets[offsets[v + 1] - 1])
+        int32 targets[arcs], completado com zeros até um múltiplo de 8 bytes
+        double weights[arcs], só se tiver pesos (weights[i] é o peso da aresta até targets[i])
+    Lança std::runtime_error se o arquivo não puder ser escrito.
+
+    Vetores de adjacências e CSR: O(n + m)
+    Matriz de adjacências: O(n^2)
+    */
+    virtual void save_binary(const std::string& filename) const;
+
+    /**
+    Carrega um grafo salvo com save_binary. O arquivo é mapeado em memória, e a representação (sempre CSR) aponta diretamente para ele: não há conversão de texto nem cópia, então o grafo fica pronto quase imediatamente, e as páginas são lidas do disco sob demanda. Se o arquivo tiver pesos, eles são ignorados.
+    Lança std::runtime_error se o arquivo não existir ou não estiver no formato.
+
+    O(1)
+    */
+    static Graph load_binary(const std::string& filename);
 };
 
 class WeightedGraph: public Graph {
 private:
     /**
-    weights[u][i] é o peso da aresta que vai de u para o seu i-ésimo vizinho (em ordem crescente de índice)
+    Todas as arestas com peso em um único vetor contíguo, com o vizinho e o peso intercalados, para que o Dijkstra leia cada aresta de um lugar só. As arestas saindo de u são arcs[arc_offsets[u]], ..., arcs[arc_offsets[u + 1] - 1], em ordem crescente de vizinho. arc_offsets tem n + 2 entradas.
+    A representação r continua tendo a topologia (sem pesos), usada pelos algoritmos de Graph.
     */
-    std::vector<std::vector<double>> weights;
+    std::vector<long long> arc_offsets;
+    std::vector<WeightedArc> arcs;
+    WeightStats stats;
+
+    // Calcula stats a partir de arcs - O(m)
+    void compute_weight_stats();
+
+    // Construtor vazio para load_binary
+    WeightedGraph() = default;
 
 public:
     /**
     Constrói o grafo. A quantidade de vértices deve ser 1 ou mais. O grafo é sempre tratado como não direcionado. Não pode haver duplicatas nas arestas (não pode haver (1,2) e (2,1), nem pode haver (1,2) duas vezes).
     Ordena os vetores de adjacências, para oferecer as ordens de busca corretas.
+    Lê o arquivo duas vezes para gastar pouca memória: a primeira passada só conta os graus; a segunda coloca cada vizinho e cada peso direto na posição final de vetores contíguos já alocados, que depois são ordenados no lugar. Nunca existe uma cópia intermediária do grafo, então o pico de memória fica perto do tamanho final do grafo (com CSR; as outras representações são montadas a partir dele).
 
-    O(n + m log m) com vetor de adjacências
+    O(n + m log m) com vetor de adjacências ou CSR
     O(n^2) com matriz de adjacências
     */
     WeightedGraph(const std::string& filename, bool use_matrix);
 
+    /**
+    Igual ao construtor acima, mas permite escolher qualquer uma das representações (inclusive CSR).
+
+    O(n + m log m) com vetor de adjacências ou CSR
+    O(n^2) com matriz de adjacências
+    */
+    WeightedGraph(const std::string& filename, RepresentationType type);
+
+    /**
+    Salva o grafo no formato binário de Graph::save_binary, com os pesos.
+
+    Vetores de adjacências e CSR: O(n + m)
+    Matriz de adjacências: O(n^2)
+    */
+    void save_binary(const std::string& filename) const override;
+
+    /**
+    Carrega um grafo com pesos salvo com save_binary. A topologia (CSR) aponta diretamente para o arquivo mapeado em memória, sem cópia; os vizinhos e pesos são intercalados em arcs, sem conversão de texto.
+    Lança std::runtime_error se o arquivo não existir, não estiver no formato ou não tiver pesos.
+
+    O(n + m)
+    */
+    static WeightedGraph load_binary(const std::string& filename);
+
     /**
     Imprime o grafo no console. Imprime sempre no formato de um vetor de adjacências, independetemente de como está internamente representado.
 
@@ -194,25 +530,88 @@ public:
     */
     void print() const override;
 
+    /**
+    Retorna uma visão das arestas (vizinho e peso) saindo de u, em ordem crescente de vizinho, sem cópia. A visão é válida enquanto o grafo existir.
+
+    O(1) para obter a visão, O(grau(u)) para percorrê-la, independentemente da representação
+    */
+    WeightedNeighborView weighted_neighbors(int u) const;
+
+    /**
+    Retorna as estatísticas dos pesos, calculadas na construção do grafo.
+
+    O(1)
+    */
+    const WeightStats& weight_stats() const {
+        return stats;
+    }
+
     /**
     Altera os vetores dists e parents com informações acerca do algoritmo de Dijkstra a partir do vértice s. No vetor dists, std::numeric_limits<double>::infinity() significa não visitado..
 
-    s deve ser um vértice válido.
+    s deve ser um vértice válido. Lança std::runtime_error se algum peso for negativo (consultando as estatísticas dos pesos, sem percorrer as arestas).
+    As arestas são lidas de arcs (vizinho e peso intercalados), então a complexidade não depende da representação.
 
-    Vetores de adjacências:
-        Usando Heap: O(n + m log n)
-        Usando apenas vetores: O(n^2)
-    Matriz de adjacências:
-        Usando Heap: O(n^2)
-        Usando apenas vetores: O(n^2)
+    Usando Heap: O(n + m log n)
+    Usando apenas vetores: O(n^2)
     */ 
     void dijkstra(int s, std::vector<double>& dists, std::vector<int>& parents, bool use_vector_only) const; 
 
+    /**
+    Igual a dijkstra acima, mas escolhendo a estrutura usada para achar o próximo vértice (ver DijkstraQueue). As distâncias são as mesmas para qualquer escolha; em caso de empate, parents pode indicar caminhos mínimos diferentes.
+
+    LAZY_HEAP: O(n + m log n), com heap de O(m) entradas
+    VECTOR_ONLY: O(n^2)
+    DARY_HEAP: O(n log n + m log n), com heap de no máximo n entradas
+    RADIX_HEAP: O(m + n log C), sendo C a maior distância vista como inteiro de 64 bits (log C <= 64), com heap de O(m) entradas
+    */
+    void dijkstra(int s, std::vector<double>& dists, std::vector<int>& parents, DijkstraQueue queue) const;
+
+    /**
+    Igual a dijkstra acima, mas usando a memória auxiliar de workspace, que é reaproveitada de uma chamada para outra.
+    */
+    void dijkstra(int s, std::vector<double>& dists, std::vector<int>& parents, DijkstraQueue queue, DijkstraWorkspace& workspace) const;
+
+    /**
+    Roda o algoritmo de Dijkstra a partir de cada vértice de sources, em threads threads (0 = todos os núcleos). Cada thread pega o próximo vértice de início ainda não processado assim que termina o anterior, e reaproveita os próprios dists, parents e DijkstraWorkspace em todas as chamadas.
+    Para cada vértice de início s, chama consume(tid, s, dists, parents) na thread tid, assim que o resultado fica pronto. consume é chamada por várias threads ao mesmo tempo, e dists e parents só valem até consume retornar. Por isso a memória é O(threads * n), e não O(|sources| * n).
+
+    Todos os vértices de sources devem ser válidos.
+
+    O(|sources| * custo de dijkstra com queue / threads), se as chamadas tiverem custo parecido
+    */
+    void dijkstra_batch(const std::vector<int>& sources, const std::function<void(int, int, const std::vector<double>&, const std::vector<int>&)>& consume, DijkstraQueue queue = DijkstraQueue::AUTO, int threads = 0) const;
+
+    /**
+    Caminhos mínimos a partir de s com o algoritmo Δ-stepping, usando threads threads (0 = todos os núcleos). Altera dists e parents como dijkstra: as distâncias são as mesmas (a menos de arredondamento de ponto flutuante) e parents forma uma árvore de caminhos mínimos válida.
+    Os vértices são divididos entre as threads (v pertence à thread v % threads), e só a dona de um vértice escreve em dists e parents dele. As distâncias provisórias ficam em baldes de largura delta. A cada balde, as threads relaxam as arestas leves (peso <= delta) até o balde esvaziar e depois as pesadas, trocando pedidos de relaxamento entre si.
+    delta <= 0 usa o maior peso dividido pelo grau médio. Se todos os pesos forem inteiros, delta é arredondado para um inteiro (pelo menos 1), para que as distâncias, também inteiras, não fiquem na borda de dois baldes.
+
+    s deve ser um vértice válido. Lança std::runtime_error se houver peso negativo.
+
+    O(n + m) por balde no pior caso, independentemente da representação
+    */
+    void delta_stepping(int s, std::vector<double>& dists, std::vector<int>& parents, double delta = 0, int threads = 0) const;
+
+    /**
+    Retorna a distância e um caminho mínimo de u até v, usando o algoritmo de Dijkstra bidirecional: uma busca a partir de u e outra a partir de v, sempre avançando a que tem menos vértices na heap. Para assim que a soma das menores distâncias das duas heaps alcança o melhor caminho já encontrado, então costuma explorar só uma pequena parte do grafo.
+
+    u e v devem ser vértices válidos. Lança std::runtime_error se algum peso for negativo.
+
+    O(n + m log n) no pior caso, independentemente da representação
+    */
+    PathQueryResult shortest_path(int u, int v) const;
+
+    /**
+    Igual a shortest_path acima, mas usando a memória auxiliar de workspace. Assim, cada consulta só custa o proporcional ao que explora, sem O(n) de inicialização.
+    */
+    PathQueryResult shortest_path(int u, int v, PointToPointWorkspace& workspace) const;
+
     /**
     Retorna a distância no grafo entre u e v. Caso não estejam conectados, retorna std::numeric_limits<double>::infinity().
+    Usa shortest_path (Dijkstra bidirecional). Como as duas metades do caminho são somadas separadamente, o resultado pode diferir de dists[v] do dijkstra no último dígito, por arredondamento.
 
-    Vetores de adjacências: O(n + m log n)
-    Matriz de adjacências: O(n^2) 
+    O(n + m log n) no pior caso, independentemente da representação
     */
     double dist_weighted(int u, int v) const;
 
@@ -225,6 +624,10 @@ public:
         throw std::runtime_error("Método não implementado");
     };
 
+    int parallel_diameter(int threads = 0) const override{
+        throw std::runtime_error("Método não implementado");
+    };
+
     int approx_diameter(){
         throw std::runtime_error("Método não implementado");
     };
@@ -0,0 +1,150 @@
+#include "Landmarks.h"
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+#include <cmath>
+
+LandmarkIndex::LandmarkIndex(const WeightedGraph& g, int landmark_count) : g(g) {
+    int n = g.get_n();
+    assert(landmark_count >= 1);
+    if (g.weight_stats().has_negative) throw std::runtime_error("LandmarkIndex não aceita pesos negativos");
+
+    k = std::min(landmark_count, n);
+    table.assign(static_cast<std::size_t>(n + 1) * k, 0);
+
+    double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> dists;
+    std::vector<int> parents;
+    DijkstraWorkspace workspace;
+
+    // closest[v] = distância de v até o landmark mais próximo já escolhido
+    std::vector<double> closest(n + 1, inf);
+    std::vector<bool> is_landmark(n + 1, false);
+
+    // O ponto de partida não vira landmark: o primeiro landmark é o vértice mais distante dele
+    g.dijkstra(1, dists, parents, DijkstraQueue::AUTO, workspace);
+    int next = 1;
+    for (int v = 1; v <= n; v++) {
+        if (dists[v] != inf && dists[v] > dists[next]) next = v;
+    }
+
+    for (int i = 0; i < k; i++) {
+        int landmark = next;
+        landmark_list.push_back(landmark);
+        is_landmark[landmark] = true;
+        g.dijkstra(landmark, dists, parents, DijkstraQueue::AUTO, workspace);
+
+        // Guardar a coluna do landmark i e escolher o próximo: o vértice com maior distância até o landmark mais próximo. Infinito (componente sem landmark) ganha de qualquer distância finita
+        next = -1;
+        for (int v = 1; v <= n; v++) {
+            table[static_cast<std::size_t>(v) * k + i] = dists[v];
+            closest[v] = std::min(closest[v], dists[v]);
+            if (is_landmark[v]) continue;
+            if (next == -1 || closest[v] > closest[next]) next = v;
+        }
+        // next só fica -1 se todos os vértices já forem landmarks, o que só acontece na última iteração (k <= n)
+    }
+}
+
+std::size_t LandmarkIndex::memory_bytes() const {
+    return table.size() * sizeof(double) + landmark_list.size() * sizeof(int);
+}
+
+double LandmarkIndex::lower_bound(const double* v_row, const double* t_row) const {
+    double inf = std::numeric_limits<double>::infinity();
+    double best = 0;
+    for (int i = 0; i < k; i++) {
+        // Landmark em outra componente que v ou t não ajuda
+        if (v_row[i] == inf || t_row[i] == inf) continue;
+        best = std::max(best, std::abs(t_row[i] - v_row[i]));
+    }
+    return best;
+}
+
+PathQueryResult LandmarkIndex::shortest_path(int u, int v) const {
+    PointToPointWorkspace workspace;
+    return shortest_path(u, v, workspace);
+}
+
+PathQueryResult LandmarkIndex::shortest_path(int u, int v, PointToPointWorkspace& workspace) const {
+    int n = g.get_n();
+    assert(1 <= u && u <= n && 1 <= v && v <= n);
+
+    double inf = std::numeric_limits<double>::infinity();
+    PathQueryResult result;
+    result.dist = inf;
+
+    const double* u_row = table.data() + static_cast<std::size_t>(u) * k;
+    const double* v_row = table.data() + static_cast<std::size_t>(v) * k;
+
+    // Um landmark na mesma componente que exatamente um dos dois prova que não estão conectados
+    for (int i = 0; i < k; i++) {
+        if ((u_row[i] == inf) != (v_row[i] == inf)) return result;
+    }
+
+    workspace.prepare(n);
+    std::vector<double>* dist = workspace.dist;
+    std::vector<int>* parent = workspace.parent;
+    IndexedDaryHeap<4>* H = workspace.heap;
+
+    // Potencial médio: p(x) = (estimativa de x até v - estimativa de x até u) / 2. A busca 0 (a partir de u) usa p e a busca 1 (a partir de v) usa -p, então as duas enxergam os mesmos pesos reduzidos (peso + p(y) - p(x) >= 0) e o critério de parada do Dijkstra bidirecional continua valendo
+    auto potential = [&](int x) {
+        const double* x_row = table.data() + static_cast<std::size_t>(x) * k;
+        return (lower_bound(x_row, v_row) - lower_bound(x_row, u_row)) / 2;
+    };
+
+    int roots[2] = {u, v};
+    for (int side = 0; side < 2; side++) {
+        int root = roots[side];
+        workspace.touch(root);
+        dist[side][root] = 0;
+        parent[side][root] = root;
+        H[side].push_or_decrease(root, side == 0 ? potential(root) : -potential(root));
+    }
+
+    double best = u == v ? 0 : inf;
+    int meet = u == v ? u : -1;
+
+    // A chave de x na busca 0 é dist[0][x] + p(x), e na busca 1 é dist[1][x] - p(x). Um vértice pode voltar para a heap se a distância dele diminuir (o arredondamento pode deixar algum peso reduzido levemente negativo), então não há marcação de explorados
+    while (!H[0].empty() && !H[1].empty() && H[0].top_key() + H[1].top_key() < best) {
+        int side = H[0].size() <= H[1].size() ? 0 : 1;
+        int other = 1 - side;
+        double sign = side == 0 ? 1 : -1;
+
+        double key;
+        int x = H[side].pop(key);
+        result.settled++;
+
+        double dx = dist[side][x];
+        for (const WeightedArc& a : g.weighted_neighbors(x)) {
+            int y = a.target;
+            double ndist = dx + a.weight;
+
+            if (ndist < dist[side][y]) {
+                workspace.touch(y);
+                dist[side][y] = ndist;
+                parent[side][y] = x;
+                H[side].push_or_decrease(y, ndist + sign * potential(y));
+            }
+            if (dist[other][y] != inf && ndist + dist[other][y] < best) {
+                best = ndist + dist[other][y];
+                meet = y;
+            }
+        }
+    }
+
+    if (meet != -1) {
+        result.dist = best;
+        for (int x = meet; x != u; x = parent[0][x]) result.path.push_back(x);
+        result.path.push_back(u);
+        std::reverse(result.path.begin(), result.path.end());
+        for (int x = meet; x != v; ) {
+            x = parent[1][x];
+            result.path.push_back(x);
+        }
+    }
+
+    workspace.clear();
+    return result;
+}
@@ -0,0 +1,58 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include "Graph.h"
+#include <vector>
+#include <cstddef>
+
+/**
+Índice ALT (A*, landmarks e desigualdade triangular) para consultas repetidas de caminho mínimo em um WeightedGraph.
+Na construção, escolhe k vértices de referência (landmarks) e guarda a distância de cada um deles até todos os vértices. Pela desigualdade triangular, |d(L, t) - d(L, v)| <= d(v, t) para todo landmark L, e o maior desses valores é usado como estimativa da distância restante no A*, que assim deixa de explorar vértices na direção errada.
+O grafo precisa continuar existindo (e sem alterações) enquanto o índice for usado.
+*/
+class LandmarkIndex {
+private:
+    const WeightedGraph& g;
+    int k;
+    std::vector<int> landmark_list;
+    std::vector<double> table; // table[v * k + i] = distância entre o landmark i e v (infinito se não estiverem conectados)
+
+    // Maior limite inferior para a distância entre v e t dado pelos landmarks - O(k)
+    double lower_bound(const double* v_row, const double* t_row) const;
+
+public:
+    /**
+    Constrói o índice com landmark_count landmarks, escolhidos por farthest-first: o primeiro é o vértice mais distante do vértice 1, e cada um dos seguintes é o vértice mais distante de todos os já escolhidos (vértices em componentes sem nenhum landmark vêm primeiro). Cada landmark custa um Dijkstra.
+    Lança std::runtime_error se algum peso for negativo.
+
+    O(k (n + m log n)) de tempo e O(k n) de memória
+    */
+    LandmarkIndex(const WeightedGraph& g, int landmark_count);
+
+    const std::vector<int>& landmarks() const {
+        return landmark_list;
+    }
+
+    /**
+    Retorna a memória usada pelas tabelas de distâncias, em bytes.
+
+    O(1)
+    */
+    std::size_t memory_bytes() const;
+
+    /**
+    Retorna a distância e um caminho mínimo de u até v usando A* bidirecional com a estimativa dos landmarks (potencial médio entre as duas buscas). A resposta é a mesma de WeightedGraph::shortest_path (a menos de arredondamento). Em grafos com estrutura geométrica (grades, malhas viárias) explora bem menos vértices; em grafos aleatórios as estimativas são fracas e o ganho é pequeno.
+
+    u e v devem ser vértices válidos.
+
+    O(k (n + m log n)) no pior caso
+    */
+    PathQueryResult shortest_path(int u, int v) const;
+
+    /**
+    Igual a shortest_path acima, mas usando a memória auxiliar de workspace (só a busca 0 é usada).
+    */
+    PathQueryResult shortest_path(int u, int v, PointToPointWorkspace& workspace) const;
+};
+
+#endif
@@ -0,0 +1,76 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& filename) {
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("Não foi possível abrir o arquivo " + filename);
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        throw std::runtime_error("Arquivo " + filename + " está vazio ou não pôde ser medido");
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        throw std::runtime_error("Não foi possível mapear o arquivo " + filename);
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Não foi possível mapear o arquivo " + filename);
+    }
+
+    ptr = static_cast<const char*>(view);
+    length = static_cast<std::size_t>(file_size.QuadPart);
+    file_handle = file;
+    mapping_handle = mapping;
+}
+
+MappedFile::~MappedFile() {
+    UnmapViewOfFile(ptr);
+    CloseHandle(mapping_handle);
+    CloseHandle(file_handle);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1) throw std::runtime_error("Não foi possível abrir o arquivo " + filename);
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || st.st_size == 0) {
+        close(fd);
+        throw std::runtime_error("Arquivo " + filename + " está vazio ou não pôde ser medido");
+    }
+
+    void* view = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // O mapeamento continua válido depois de fechar o descritor
+    if (view == MAP_FAILED) throw std::runtime_error("Não foi possível mapear o arquivo " + filename);
+
+    ptr = static_cast<const char*>(view);
+    length = st.st_size;
+}
+
+MappedFile::~MappedFile() {
+    munmap(const_cast<char*>(ptr), length);
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+/**
+Arquivo mapeado em memória, somente para leitura. O conteúdo fica acessível por data() enquanto o objeto existir, e as páginas são trazidas do disco sob demanda pelo sistema operacional (nada é copiado nem convertido na abertura).
+Usa mmap no Linux/macOS e MapViewOfFile no Windows.
+*/
+class MappedFile {
+private:
+    const char* ptr = nullptr;
+    std::size_t length = 0;
+#ifdef _WIN32
+    void* file_handle = nullptr;
+    void* mapping_handle = nullptr;
+#endif
+
+public:
+    /**
+    Mapeia o arquivo filename inteiro. Lança std::runtime_error se o arquivo não puder ser aberto ou mapeado, ou se estiver vazio.
+
+    O(1)
+    */
+    explicit MappedFile(const std::string& filename);
+
+    /**
+    Desfaz o mapeamento.
+    */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const {
+        return ptr;
+    }
+
+    std::size_t size() const {
+        return length;
+    }
+};
+
+#endif
@@ -0,0 +1,114 @@
+#include "OutputWriter.h"
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <cassert>
+
+namespace {
+    // Maior quantidade de caracteres de um número convertido por to_chars (int64 com sinal ou double em %g)
+    const std::size_t MAX_NUMBER_CHARS = 32;
+}
+
+BufferedWriter::BufferedWriter(const std::string& filename, OutputFormat format, std::size_t buffer_size) : filename(filename), buffer(buffer_size < 64 ? 64 : buffer_size) {
+    file = std::fopen(filename.c_str(), format == OutputFormat::BINARY ? "wb" : "w");
+    if (!file) throw std::runtime_error("Não foi possível criar o arquivo " + filename);
+}
+
+BufferedWriter::~BufferedWriter() {
+    if (file) {
+        flush();
+        std::fclose(file);
+    }
+}
+
+void BufferedWriter::flush() {
+    if (used > 0 && std::fwrite(buffer.data(), 1, used, file) != used) failed = true;
+    used = 0;
+}
+
+char* BufferedWriter::reserve(std::size_t bytes) {
+    assert(bytes <= buffer.size());
+    if (buffer.size() - used < bytes) flush();
+    return buffer.data() + used;
+}
+
+void BufferedWriter::write_raw(const void* data, std::size_t size) {
+    assert(file);
+    const char* p = static_cast<const char*>(data);
+    if (size > buffer.size() - used) {
+        flush();
+        // Blocos maiores que o buffer vão direto para o arquivo, sem cópia
+        if (size >= buffer.size()) {
+            if (std::fwrite(p, 1, size, file) != size) failed = true;
+            return;
+        }
+    }
+    std::memcpy(buffer.data() + used, p, size);
+    used += size;
+}
+
+BufferedWriter& BufferedWriter::operator<<(const std::string& s) {
+    write_raw(s.data(), s.size());
+    return *this;
+}
+
+BufferedWriter& BufferedWriter::operator<<(const char* s) {
+    write_raw(s, std::strlen(s));
+    return *this;
+}
+
+BufferedWriter& BufferedWriter::operator<<(char c) {
+    *reserve(1) = c;
+    used++;
+    return *this;
+}
+
+template <typename T>
+BufferedWriter& BufferedWriter::write_integer(T x) {
+    char* first = reserve(MAX_NUMBER_CHARS);
+    std::to_chars_result result = std::to_chars(first, first + MAX_NUMBER_CHARS, x);
+    assert(result.ec == std::errc());
+    used = result.ptr - buffer.data();
+    return *this;
+}
+
+BufferedWriter& BufferedWriter::operator<<(int x) {
+    return write_integer(x);
+}
+
+BufferedWriter& BufferedWriter::operator<<(long long x) {
+    return write_integer(x);
+}
+
+BufferedWriter& BufferedWriter::operator<<(unsigned long long x) {
+    return write_integer(x);
+}
+
+BufferedWriter& BufferedWriter::operator<<(unsigned long x) {
+    return write_integer(x);
+}
+
+BufferedWriter& BufferedWriter::operator<<(long x) {
+    return write_integer(x);
+}
+
+BufferedWriter& BufferedWriter::operator<<(unsigned int x) {
+    return write_integer(x);
+}
+
+BufferedWriter& BufferedWriter::operator<<(double x) {
+    // Mesmo texto de std::ostream com a precisão padrão: %g com 6 algarismos significativos
+    char* first = reserve(MAX_NUMBER_CHARS);
+    std::to_chars_result result = std::to_chars(first, first + MAX_NUMBER_CHARS, x, std::chars_format::general, 6);
+    assert(result.ec == std::errc());
+    used = result.ptr - buffer.data();
+    return *this;
+}
+
+void BufferedWriter::close() {
+    assert(file);
+    flush();
+    bool ok = (std::fclose(file) == 0) && !failed;
+    file = nullptr;
+    if (!ok) throw std::runtime_error("Erro ao escrever o arquivo " + filename);
+}
@@ -0,0 +1,89 @@
+#ifndef OUTPUT_WRITER_H
+#define OUTPUT_WRITER_H
+
+#include <cstdio>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+Formato dos arquivos escritos pelos métodos write_* de Graph.
+    TEXT: texto legível, uma linha por vértice (o formato de sempre)
+    BINARY: colunar, com os vetores inteiros (pais, níveis, membros das componentes...) gravados direto, na ordem de bytes da máquina. O layout de cada arquivo está na documentação do método que o escreve
+*/
+enum class OutputFormat {
+    TEXT,
+    BINARY
+};
+
+/**
+Escrita de arquivos com um buffer grande, sem std::ofstream: os números são convertidos com std::to_chars direto no buffer, e o buffer só vai para o arquivo (com fwrite) quando enche ou no fim. Serve tanto para texto (operator<<) quanto para binário (write_raw).
+Os inteiros saem como em std::ostream, e os doubles como em std::ostream com a precisão padrão (%g com 6 algarismos).
+*/
+class BufferedWriter {
+private:
+    std::FILE* file = nullptr;
+    std::string filename;
+    std::vector<char> buffer;
+    std::size_t used = 0;
+    bool failed = false;
+
+    // Manda o buffer para o arquivo e o esvazia - O(tamanho do buffer)
+    void flush();
+
+    // Garante que há pelo menos bytes bytes livres no buffer (bytes não pode passar do tamanho do buffer)
+    char* reserve(std::size_t bytes);
+
+    // Escreve o inteiro x em decimal com std::to_chars
+    template <typename T>
+    BufferedWriter& write_integer(T x);
+
+public:
+    /**
+    Cria (ou sobrescreve) o arquivo filename. Lança std::runtime_error se não conseguir.
+    Em OutputFormat::TEXT, o arquivo é aberto em modo texto, então as quebras de linha ficam iguais às de std::ofstream na plataforma. Em OutputFormat::BINARY, os bytes são gravados sem nenhuma conversão.
+    buffer_size é o tamanho do buffer em bytes (pelo menos 64).
+    */
+    explicit BufferedWriter(const std::string& filename, OutputFormat format = OutputFormat::TEXT, std::size_t buffer_size = 1 << 20);
+
+    // Fecha o arquivo se close não foi chamado. Erros nesse caso são ignorados; use close para detectá-los
+    ~BufferedWriter();
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    /**
+    Escreve size bytes de data.
+
+    O(size)
+    */
+    void write_raw(const void* data, std::size_t size);
+
+    /**
+    Escreve os count elementos de data como bytes crus, na ordem de bytes da máquina.
+
+    O(count)
+    */
+    template <typename T>
+    void write_array(const T* data, std::size_t count) {
+        write_raw(data, count * sizeof(T));
+    }
+
+    BufferedWriter& operator<<(const std::string& s);
+    BufferedWriter& operator<<(const char* s);
+    BufferedWriter& operator<<(char c);
+    BufferedWriter& operator<<(int x);
+    BufferedWriter& operator<<(long long x);
+    BufferedWriter& operator<<(unsigned long long x);
+    BufferedWriter& operator<<(unsigned long x);
+    BufferedWriter& operator<<(long x);
+    BufferedWriter& operator<<(unsigned int x);
+    BufferedWriter& operator<<(double x);
+
+    /**
+    Manda o que falta para o arquivo e o fecha. Lança std::runtime_error se alguma escrita tiver falhado.
+    */
+    void close();
+};
+
+#endif
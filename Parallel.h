@@ -0,0 +1,61 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+/**
+Retorna a quantidade de threads a usar: threads, se for positivo, ou a quantidade de núcleos da máquina, se for 0 ou negativo. Sempre retorna pelo menos 1.
+
+O(1)
+*/
+inline int resolve_thread_count(int threads) {
+    if (threads <= 0) threads = std::thread::hardware_concurrency();
+    return threads >= 1 ? threads : 1;
+}
+
+/**
+Roda f(tid) em threads threads (tid de 0 a threads - 1) e espera todas terminarem. A thread atual faz o papel da thread 0, então threads = 1 não cria nenhuma thread nova.
+*/
+template <typename F>
+void run_in_threads(int threads, F f) {
+    std::vector<std::thread> workers;
+    for (int tid = 1; tid < threads; tid++) {
+        workers.emplace_back(f, tid);
+    }
+    f(0);
+    for (std::thread& t : workers) {
+        t.join();
+    }
+}
+
+/**
+Barreira reutilizável: wait() só retorna quando todas as count threads chamaram wait(). Depois disso, pode ser usada de novo. Tudo o que as threads escreveram antes de wait() é visível para todas depois de wait().
+*/
+class Barrier {
+private:
+    std::mutex m;
+    std::condition_variable cv;
+    int count;
+    int waiting = 0;
+    long long generation = 0;
+
+public:
+    explicit Barrier(int count) : count(count) {}
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(m);
+        long long my_generation = generation;
+        if (++waiting == count) {
+            waiting = 0;
+            generation++;
+            cv.notify_all();
+        } else {
+            cv.wait(lock, [&] { return generation != my_generation; });
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,245 @@
+#ifndef PRIORITY_QUEUES_H
+#define PRIORITY_QUEUES_H
+
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+/**
+Retorna a quantidade de bits necessária para escrever x, ou seja, a posição do bit 1 mais alto mais 1. Retorna 0 se x for 0.
+O(1)
+*/
+inline int bit_width(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return x ? 64 - __builtin_clzll(x) : 0;
+#else
+    int result = 0;
+    while (x) {
+        x >>= 1;
+        result++;
+    }
+    return result;
+#endif
+}
+
+/**
+Heap mínima D-ária indexada, com chaves double e itens inteiros de 0 a capacidade - 1 (vértices). Cada item aparece no máximo uma vez, então a heap nunca passa de n entradas: diminuir a chave de um item que já está na heap (decrease-key) move a entrada existente, em vez de inserir outra.
+Com D = 4, a árvore é mais rasa que a binária e os filhos de um nó ficam lado a lado na memória.
+*/
+template <int D>
+class IndexedDaryHeap {
+private:
+    struct Entry {
+        double key;
+        int item;
+    };
+
+    std::vector<Entry> heap;
+    std::vector<int> position; // position[item] é a posição do item em heap, ou -1 se não está na heap
+
+    void place(int i, const Entry& e) {
+        heap[i] = e;
+        position[e.item] = i;
+    }
+
+    // Sobe a entrada e, que deveria ficar na posição i, até o lugar certo. O(log_D n)
+    void sift_up(int i, Entry e) {
+        while (i > 0) {
+            int parent = (i - 1) / D;
+            if (heap[parent].key <= e.key) break;
+            place(i, heap[parent]);
+            i = parent;
+        }
+        place(i, e);
+    }
+
+    // Desce a entrada e, que deveria ficar na posição i, até o lugar certo. O(D log_D n)
+    void sift_down(int i, Entry e) {
+        int size = heap.size();
+        while (true) {
+            int first = D * i + 1;
+            if (first >= size) break;
+            int last = first + D < size ? first + D : size;
+            int best = first;
+            for (int c = first + 1; c < last; c++) {
+                if (heap[c].key < heap[best].key) best = c;
+            }
+            if (e.key <= heap[best].key) break;
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, e);
+    }
+
+public:
+    /**
+    Esvazia a heap e prepara para itens de 0 a capacity - 1. Reaproveita a memória já alocada.
+
+    O(capacity)
+    */
+    void reset(int capacity) {
+        heap.clear();
+        position.assign(capacity, -1);
+    }
+
+    /**
+    Esvazia a heap, sem mudar a capacidade. Diferente de reset, só mexe nas posições dos itens que ainda estão na heap.
+
+    O(tamanho da heap)
+    */
+    void clear() {
+        for (const Entry& e : heap) position[e.item] = -1;
+        heap.clear();
+    }
+
+    int capacity() const {
+        return position.size();
+    }
+
+    bool empty() const {
+        return heap.empty();
+    }
+
+    int size() const {
+        return heap.size();
+    }
+
+    /**
+    Retorna a menor chave, sem remover. A heap não pode estar vazia.
+
+    O(1)
+    */
+    double top_key() const {
+        assert(!heap.empty());
+        return heap[0].key;
+    }
+
+    /**
+    Insere item com a chave key, ou diminui a chave dele se já estiver na heap (chaves maiores que a atual são ignoradas).
+
+    O(log_D n)
+    */
+    void push_or_decrease(int item, double key) {
+        int i = position[item];
+        if (i == -1) {
+            heap.push_back(Entry{key, item});
+            sift_up(heap.size() - 1, Entry{key, item});
+        } else if (key < heap[i].key) {
+            sift_up(i, Entry{key, item});
+        }
+    }
+
+    /**
+    Remove o item de menor chave, retornando-o, e altera key com a chave dele. A heap não pode estar vazia.
+
+    O(D log_D n)
+    */
+    int pop(double& key) {
+        assert(!heap.empty());
+        Entry top = heap[0];
+        position[top.item] = -1;
+
+        Entry last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) sift_down(0, last);
+
+        key = top.key;
+        return top.item;
+    }
+};
+
+/**
+Heap radix: fila de prioridade monótona, com chaves double não negativas e itens inteiros. Monótona quer dizer que nenhuma chave inserida pode ser menor que a última removida, o que vale no algoritmo de Dijkstra com pesos não negativos.
+Para double não negativo (sem -0.0 e sem NaN), comparar os valores é o mesmo que comparar os bits como inteiros sem sinal. O balde de uma chave é a posição do bit mais alto em que ela difere da última chave removida, então há só 65 baldes e nenhuma comparação entre chaves para inserir.
+Não tem decrease-key: um item pode aparecer mais de uma vez, e quem usa deve ignorar as entradas velhas.
+*/
+class RadixHeap {
+private:
+    struct Entry {
+        std::uint64_t key;
+        int item;
+    };
+
+    std::vector<Entry> buckets[65];
+    std::uint64_t last = 0; // Bits da última chave removida
+    int count = 0;
+
+    int bucket_of(std::uint64_t key) const {
+        return bit_width(key ^ last);
+    }
+
+    static std::uint64_t to_bits(double key) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &key, sizeof(bits));
+        return bits;
+    }
+
+    static double from_bits(std::uint64_t bits) {
+        double key;
+        std::memcpy(&key, &bits, sizeof(key));
+        return key;
+    }
+
+public:
+    /**
+    Esvazia a heap. Reaproveita a memória já alocada nos baldes.
+
+    O(65)
+    */
+    void reset() {
+        for (std::vector<Entry>& b : buckets) b.clear();
+        last = 0;
+        count = 0;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    /**
+    Insere item com a chave key. key não pode ser menor que a última chave removida.
+
+    O(1)
+    */
+    void push(int item, double key) {
+        std::uint64_t bits = to_bits(key);
+        assert(bits >= last);
+        buckets[bucket_of(bits)].push_back(Entry{bits, item});
+        count++;
+    }
+
+    /**
+    Remove um item de menor chave, retornando-o, e altera key com a chave dele. A heap não pode estar vazia.
+
+    O(log C) amortizado, sendo C a maior chave: cada entrada só desce de balde, e há 65 baldes
+    */
+    int pop(double& key) {
+        assert(count > 0);
+        if (buckets[0].empty()) {
+            // Acha o primeiro balde não vazio, e redistribui as entradas dele em relação à menor chave do balde. Todas vão para baldes menores
+            int i = 1;
+            while (buckets[i].empty()) i++;
+
+            std::uint64_t min_key = buckets[i][0].key;
+            for (const Entry& e : buckets[i]) {
+                if (e.key < min_key) min_key = e.key;
+            }
+
+            last = min_key;
+            for (const Entry& e : buckets[i]) {
+                buckets[bucket_of(e.key)].push_back(e);
+            }
+            buckets[i].clear();
+        }
+
+        Entry top = buckets[0].back();
+        buckets[0].pop_back();
+        count--;
+
+        key = from_bits(top.key);
+        return top.item;
+    }
+};
+
+#endif
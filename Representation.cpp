@@ -33,6 +33,17 @@ std::vector<int> AdjacencyVector::neighbors(int v) const {
     return vec[v];
 }
 
+NeighborView AdjacencyVector::neighbor_view(int v) const {
+    assert(1 <= v && v <= get_n());
+    const int* first = vec[v].data();
+    return NeighborView(first, first + vec[v].size());
+}
+
+int AdjacencyVector::degree(int v) const {
+    assert(1 <= v && v <= get_n());
+    return vec[v].size();
+}
+
 void AdjacencyVector::print() const {
     int n = get_n();
     std::cout << "Vértices: " << n << "\n";
@@ -46,18 +57,32 @@ void AdjacencyVector::print() const {
     }
 }
 
+void AdjacencyMatrix::allocate(int n) {
+    this->n = n;
+    words_per_row = (n + 1 + 63) / 64; // Colunas 0 a n
+    bits.assign(static_cast<std::size_t>(n + 1) * words_per_row, 0); // Operação O(n^2), uma única alocação
+}
+
+void AdjacencyMatrix::set(int u, int v) {
+    bits[static_cast<std::size_t>(u) * words_per_row + v / 64] |= std::uint64_t(1) << (v % 64);
+}
+
+bool AdjacencyMatrix::test(int u, int v) const {
+    return (bits[static_cast<std::size_t>(u) * words_per_row + v / 64] >> (v % 64)) & 1;
+}
+
 AdjacencyMatrix::AdjacencyMatrix(int n, const std::vector<std::pair<int, int>>& edges) {
     assert(n >= 1);
 
-    mat.assign(n + 1, std::vector<bool>(n + 1, false)); // Operação O(n^2)
+    allocate(n); // Operação O(n^2)
     // Deixaremos a primeira posição de tudo vazia, pois os vértices começam em 1
 
     // Operações O(m)
     for (auto edge : edges) {
         int u = edge.first;
         int v = edge.second;
-        mat[u][v] = true;
-        mat[v][u] = true; // grafo não direcionado
+        set(u, v);
+        set(v, u); // grafo não direcionado
     }
 }
 
@@ -66,37 +91,149 @@ AdjacencyMatrix::AdjacencyMatrix(std::vector<std::vector<int>>&& adj_vector) {
     std::vector<std::vector<int>> lvector = std::move(adj_vector);
 
     int n = lvector.size() - 1;
-    mat.assign(n + 1, std::vector<bool>(n + 1, false)); // O(n^2)
+    allocate(n); // O(n^2)
 
     for (int u = 1; u <= n; u++) {
         for (int v : lvector[u]) {
-            mat[u][v] = true;
+            set(u, v);
         }
     }
 }
 
 int AdjacencyMatrix::get_n() const {
-    return mat.size() - 1;
+    return n;
 }
 
 std::vector<int> AdjacencyMatrix::neighbors(int v) const {
-    std::vector<int> result;
-    int n = get_n();
+    NeighborView view = neighbor_view(v);
+    return std::vector<int>(view.begin(), view.end());
+}
+
+NeighborView AdjacencyMatrix::neighbor_view(int v) const {
     assert(1 <= v && v <= n);
-    for (int j = 1; j <= n; j++) {
-        if (mat[v][j]) result.push_back(j);
+    return NeighborView(bits.data() + static_cast<std::size_t>(v) * words_per_row, words_per_row);
+}
+
+int AdjacencyMatrix::degree(int v) const {
+    assert(1 <= v && v <= n);
+    const std::uint64_t* row = bits.data() + static_cast<std::size_t>(v) * words_per_row;
+    int result = 0;
+    for (int i = 0; i < words_per_row; i++) {
+        result += popcount(row[i]);
     }
     return result;
 }
 
 void AdjacencyMatrix::print() const {
-    int n = get_n();
     std::cout << "Vértices: " << n << "\n";
     std::cout << "Matriz de adjacências:\n";
     for (int i = 1; i <= n; i++) {
         for (int j = 1; j <= n; j++) {
-            std::cout << mat[i][j] << " ";
+            std::cout << test(i, j) << " ";
         }
         std::cout << "\n";
     }
-}
\ No newline at end of file
+}
+
+CompressedSparseRow::CompressedSparseRow(int n, const std::vector<std::pair<int, int>>& edges) {
+    assert(n >= 1);
+
+    // Contar os graus (O(n + m)). O grau de v fica, temporariamente, em offsets[v + 1]
+    offsets.assign(n + 2, 0);
+    for (auto edge : edges) {
+        offsets[edge.first + 1]++;
+        offsets[edge.second + 1]++; // grafo não direcionado
+    }
+
+    // Soma de prefixos (O(n))
+    for (int v = 1; v <= n; v++) {
+        offsets[v + 1] += offsets[v];
+    }
+
+    // Preencher cada vizinho na sua posição final (O(m))
+    targets.resize(offsets[n + 1]);
+    std::vector<long long> next(offsets.begin(), offsets.end() - 1);
+    for (auto edge : edges) {
+        int u = edge.first;
+        int v = edge.second;
+        targets[next[u]++] = v;
+        targets[next[v]++] = u;
+    }
+
+    // Operação O(m log m)
+    for (int v = 1; v <= n; v++) {
+        std::sort(targets.begin() + offsets[v], targets.begin() + offsets[v + 1]);
+    }
+
+    use_own_storage();
+}
+
+CompressedSparseRow::CompressedSparseRow(std::vector<std::vector<int>>&& adj_vector) {
+    // Destruir adj_vector para ter comportamento consistente com o construtor de AdjacencyVector
+    std::vector<std::vector<int>> lvector = std::move(adj_vector);
+
+    int n = lvector.size() - 1;
+    offsets.assign(n + 2, 0);
+    for (int v = 1; v <= n; v++) {
+        offsets[v + 1] = offsets[v] + lvector[v].size();
+    }
+
+    targets.reserve(offsets[n + 1]);
+    for (int v = 1; v <= n; v++) {
+        targets.insert(targets.end(), lvector[v].begin(), lvector[v].end());
+
+        // Destruir a linha para liberar memória
+        lvector[v].clear();
+        lvector[v].shrink_to_fit();
+    }
+
+    use_own_storage();
+}
+
+CompressedSparseRow::CompressedSparseRow(std::vector<long long>&& offsets, std::vector<int>&& targets)
+    : offsets(std::move(offsets)), targets(std::move(targets)) {
+    assert(this->offsets.size() >= 3);
+    use_own_storage();
+}
+
+CompressedSparseRow::CompressedSparseRow(int n, const long long* offsets, const int* targets, std::shared_ptr<const void> owner)
+    : offsets_data(offsets), targets_data(targets), n(n), external(std::move(owner)) {
+    assert(n >= 1);
+}
+
+void CompressedSparseRow::use_own_storage() {
+    offsets_data = offsets.data();
+    targets_data = targets.data();
+    n = offsets.size() - 2;
+}
+
+int CompressedSparseRow::get_n() const {
+    return n;
+}
+
+std::vector<int> CompressedSparseRow::neighbors(int v) const {
+    assert(1 <= v && v <= n);
+    return std::vector<int>(targets_data + offsets_data[v], targets_data + offsets_data[v + 1]);
+}
+
+NeighborView CompressedSparseRow::neighbor_view(int v) const {
+    assert(1 <= v && v <= n);
+    return NeighborView(targets_data + offsets_data[v], targets_data + offsets_data[v + 1]);
+}
+
+int CompressedSparseRow::degree(int v) const {
+    assert(1 <= v && v <= n);
+    return offsets_data[v + 1] - offsets_data[v];
+}
+
+void CompressedSparseRow::print() const {
+    std::cout << "Vértices: " << n << "\n";
+    std::cout << "Vetor de adjacências (CSR):\n";
+    for (int i = 1; i <= n; i++) {
+        std::cout << i << ": ";
+        for (long long j = offsets_data[i]; j < offsets_data[i + 1]; j++) {
+            std::cout << targets_data[j] << " ";
+        }
+        std::cout << "\n";
+    }
+}
@@ -3,6 +3,139 @@
 
 #include <vector>
 #include <string>
+#include <iterator>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+Retorna a quantidade de zeros à direita do primeiro bit 1 de x. x não pode ser 0.
+O(1)
+*/
+inline int count_trailing_zeros(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int result = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        result++;
+    }
+    return result;
+#endif
+}
+
+/**
+Retorna a quantidade de bits 1 em x.
+O(1)
+*/
+inline int popcount(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    int result = 0;
+    while (x) {
+        x &= x - 1;
+        result++;
+    }
+    return result;
+#endif
+}
+
+/**
+Visão dos vizinhos de um vértice, em ordem crescente de índice, sem cópia e sem alocação. Pode ser percorrida com for (int w : view).
+Nas representações contíguas (vetor de adjacências e CSR), é apenas um par de ponteiros para a lista de adjacências. Na matriz de adjacências, percorre as palavras de 64 bits da linha, pulando as palavras vazias e achando cada vizinho com count_trailing_zeros.
+A visão só é válida enquanto a representação que a gerou existir e não for alterada.
+*/
+class NeighborView {
+public:
+    class iterator {
+    private:
+        const int* p = nullptr;                  // Representações contíguas
+        const std::uint64_t* words = nullptr;    // Matriz de adjacências
+        int word_count = 0;
+        int word_idx = 0;
+        std::uint64_t cur = 0;                   // Bits ainda não visitados da palavra word_idx
+
+        // Avança até a próxima palavra não vazia (ou até o fim)
+        void skip_empty() {
+            while (cur == 0 && ++word_idx < word_count) cur = words[word_idx];
+        }
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = int;
+
+        iterator(const int* p) : p(p) {}
+        iterator(const std::uint64_t* words, int word_count, int word_idx) : words(words), word_count(word_count), word_idx(word_idx) {
+            if (word_idx < word_count) {
+                cur = words[word_idx];
+                skip_empty();
+            }
+        }
+
+        int operator*() const {
+            return words ? word_idx * 64 + count_trailing_zeros(cur) : *p;
+        }
+
+        iterator& operator++() {
+            if (words) {
+                cur &= cur - 1; // Apaga o bit 1 mais à direita
+                skip_empty();
+            } else {
+                p++;
+            }
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const {
+            return words ? (word_idx == other.word_idx && cur == other.cur) : p == other.p;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    /**
+    Visão de um trecho contíguo [first, last).
+    */
+    NeighborView(const int* first, const int* last) : first(first), last(last) {}
+
+    /**
+    Visão de uma linha da matriz de adjacências, com word_count palavras de 64 bits. O bit j da linha indica se j é vizinho.
+    */
+    NeighborView(const std::uint64_t* words, int word_count) : words(words), word_count(word_count) {}
+
+    iterator begin() const {
+        return words ? iterator(words, word_count, 0) : iterator(first);
+    }
+
+    iterator end() const {
+        return words ? iterator(words, word_count, word_count) : iterator(last);
+    }
+
+    /**
+    Retorna a quantidade de vizinhos.
+    Representações contíguas: O(1)
+    Matriz de adjacências: O(n/64)
+    */
+    int size() const {
+        if (!words) return last - first;
+        int result = 0;
+        for (int i = 0; i < word_count; i++) result += popcount(words[i]);
+        return result;
+    }
+
+private:
+    const int* first = nullptr;
+    const int* last = nullptr;
+    const std::uint64_t* words = nullptr;
+    int word_count = 0;
+};
 
 class GraphRepresentation {
 public:
@@ -30,6 +163,19 @@ public:
     Matriz de adjacências: O(n)
     */
     virtual std::vector<int> neighbors(int v) const = 0;
+
+    /**
+    Retorna uma visão dos vizinhos do vértice v (de 1 a n), em ordem crescente, sem copiar nada.
+    O(1) para obter a visão. Percorrê-la custa O(grau(v)) nas representações contíguas e O(n/64 + grau(v)) na matriz de adjacências.
+    */
+    virtual NeighborView neighbor_view(int v) const = 0;
+
+    /**
+    Retorna o grau do vértice v (de 1 a n), sem percorrer nem copiar os vizinhos.
+    Representações contíguas: O(1)
+    Matriz de adjacências: O(n/64)
+    */
+    virtual int degree(int v) const = 0;
 };
 
 class AdjacencyVector : public GraphRepresentation {
@@ -67,6 +213,20 @@ public:
     */
     std::vector<int> neighbors(int v) const override;
 
+    /**
+    Retorna uma visão da lista de adjacências de v, sem cópia.
+
+    O(1)
+    */
+    NeighborView neighbor_view(int v) const override;
+
+    /**
+    Retorna o tamanho da lista de adjacências de v.
+
+    O(1)
+    */
+    int degree(int v) const override;
+
     /**
     Imprime o vetor de adjacências no console.
 
@@ -77,7 +237,33 @@ public:
 
 class AdjacencyMatrix : public GraphRepresentation {
 private:
-    std::vector<std::vector<bool>> mat;
+    /**
+    Matriz inteira em um único bloco contíguo. Cada linha tem words_per_row palavras de 64 bits, e o bit j da linha u indica se existe a aresta (u, j). A linha e a coluna 0 ficam vazias, pois os vértices começam em 1.
+    */
+    std::vector<std::uint64_t> bits;
+    int n = 0;
+    int words_per_row = 0;
+
+    /**
+    Aloca a matriz vazia com n vértices.
+
+    O(n^2)
+    */
+    void allocate(int n);
+
+    /**
+    Marca a aresta (u, v) (só nesse sentido).
+
+    O(1)
+    */
+    void set(int u, int v);
+
+    /**
+    Retorna true <-> existe a aresta (u, v).
+
+    O(1)
+    */
+    bool test(int u, int v) const;
 
 public:
     /**
@@ -104,10 +290,24 @@ public:
     /**
     Retorna um vetor com os vizinhos de v, em ordem crescente de índice.
 
-    O(n) 
+    O(n/64 + grau(v))
     */
     std::vector<int> neighbors(int v) const override;
 
+    /**
+    Retorna uma visão da linha de v na matriz, sem cópia.
+
+    O(1) para obter a visão, O(n/64 + grau(v)) para percorrê-la
+    */
+    NeighborView neighbor_view(int v) const override;
+
+    /**
+    Retorna a quantidade de bits 1 na linha de v, com popcount palavra a palavra.
+
+    O(n/64)
+    */
+    int degree(int v) const override;
+
     /**
     Imprime a matriz de adjacências no console.
 
@@ -116,4 +316,100 @@ public:
     void print() const override;
 };
 
+class CompressedSparseRow : public GraphRepresentation {
+private:
+    /**
+    offsets[v] é a posição em targets onde começam os vizinhos de v. Os vizinhos de v ficam em targets[offsets[v]], ..., targets[offsets[v + 1] - 1], em ordem crescente. offsets tem n + 2 entradas, e as entradas 0 e 1 são 0 (o vértice 0 não existe).
+    */
+    std::vector<long long> offsets;
+
+    /**
+    Todas as listas de adjacências concatenadas em um único vetor contíguo (2m entradas).
+    */
+    std::vector<int> targets;
+
+    /**
+    Dados efetivamente usados. Apontam para offsets e targets, ou para memória externa (por exemplo, um arquivo binário mapeado em memória), que nesse caso é mantida viva por external.
+    */
+    const long long* offsets_data = nullptr;
+    const int* targets_data = nullptr;
+    int n = 0;
+    std::shared_ptr<const void> external;
+
+    /**
+    Faz offsets_data e targets_data apontarem para offsets e targets.
+
+    O(1)
+    */
+    void use_own_storage();
+
+public:
+    /**
+    Constrói a representação CSR. Primeiro conta os graus, depois preenche targets diretamente na posição final de cada vizinho, e por fim ordena cada trecho.
+
+    O(n + m log m)
+    */
+    CompressedSparseRow(int n, const std::vector<std::pair<int, int>>& edges);
+
+    /**
+    Recebe um vetor de adjacências já pronto (e já ordenado), e cria a partir dele a representação CSR. As linhas de adj_vector são desalocadas conforme são copiadas. Útil no construtor de grafo com peso.
+
+    O(n + m)
+    */
+    explicit CompressedSparseRow(std::vector<std::vector<int>>&& adj_vector);
+
+    /**
+    Recebe offsets (n + 2 entradas) e targets já prontos (e já ordenados em cada trecho), e passa a ser dona deles, sem copiar.
+
+    O(1)
+    */
+    CompressedSparseRow(std::vector<long long>&& offsets, std::vector<int>&& targets);
+
+    /**
+    Usa arrays offsets (n + 2 entradas) e targets que já estão prontos em memória externa, sem copiar nada. owner deve manter essa memória viva (a representação guarda uma cópia de owner). Útil para carregar um grafo binário mapeado em memória.
+
+    O(1)
+    */
+    CompressedSparseRow(int n, const long long* offsets, const int* targets, std::shared_ptr<const void> owner);
+
+    // Os ponteiros internos tornariam uma cópia inválida
+    CompressedSparseRow(const CompressedSparseRow&) = delete;
+    CompressedSparseRow& operator=(const CompressedSparseRow&) = delete;
+
+    /**
+    Retorna o número de vértices.
+
+    O(1)
+    */
+    int get_n() const override;
+
+    /**
+    Retorna um vetor com os vizinhos de v, em ordem crescente de índice.
+
+    O(grau(v))
+    */
+    std::vector<int> neighbors(int v) const override;
+
+    /**
+    Retorna uma visão da lista de adjacências de v, sem cópia.
+
+    O(1)
+    */
+    NeighborView neighbor_view(int v) const override;
+
+    /**
+    Retorna o tamanho da lista de adjacências de v.
+
+    O(1)
+    */
+    int degree(int v) const override;
+
+    /**
+    Imprime o vetor de adjacências no console.
+
+    O(n + m)
+    */
+    void print() const override;
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,87 @@
+#ifndef UNION_FIND_H
+#define UNION_FIND_H
+
+#include <atomic>
+#include <vector>
+#include <cassert>
+#include <utility>
+
+/**
+Union-find (conjuntos disjuntos) sobre os vértices 1 a n, que pode ser usado por várias threads ao mesmo tempo sem travas.
+unite liga sempre a raiz de maior índice na de menor índice com compare_exchange, como no Shiloach-Vishkin e no Afforest. Como os ponteiros só apontam para índices menores, não se formam ciclos, e a raiz de cada conjunto é sempre o seu menor vértice. find encurta o caminho pela metade (path halving) enquanto sobe.
+*/
+class ConcurrentUnionFind {
+private:
+    std::vector<std::atomic<int>> parent; // n + 1 entradas; parent[v] == v <-> v é raiz
+
+public:
+    /**
+    Cria n conjuntos unitários {1}, ..., {n}.
+
+    O(n)
+    */
+    explicit ConcurrentUnionFind(int n) : parent(n + 1) {
+        for (int v = 0; v <= n; v++) {
+            parent[v].store(v, std::memory_order_relaxed);
+        }
+    }
+
+    int get_n() const {
+        return static_cast<int>(parent.size()) - 1;
+    }
+
+    /**
+    Retorna a raiz do conjunto de v. Se outra thread estiver unindo conjuntos ao mesmo tempo, a resposta pode ficar velha logo depois, mas sempre foi raiz em algum momento da chamada.
+
+    O(log n) amortizado
+    */
+    int find(int v) {
+        assert(1 <= v && v <= get_n());
+        while (true) {
+            int p = parent[v].load(std::memory_order_relaxed);
+            if (p == v) return v;
+            int gp = parent[p].load(std::memory_order_relaxed);
+            if (gp == p) return p;
+            // Pular o pai. Se outra thread já mudou parent[v], ele continua apontando para um ancestral, então tanto faz
+            parent[v].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+            v = gp;
+        }
+    }
+
+    /**
+    Une os conjuntos de a e b.
+
+    O(log n) amortizado
+    */
+    void unite(int a, int b) {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return;
+            if (a < b) std::swap(a, b);
+
+            // Ligar a (maior) em b (menor), desde que a ainda seja raiz; senão, tentar de novo a partir das raízes novas
+            int expected = a;
+            if (parent[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel)) return;
+        }
+    }
+
+    /**
+    Retorna um vector<int> resultante com n + 1 entradas. A entrada 0 é -1. resultante[v] é o índice do conjunto de v, numerando os conjuntos de 0 em diante na ordem do menor vértice de cada um. Não pode ser chamada enquanto outras threads usam o union-find.
+
+    O(n)
+    */
+    std::vector<int> labels() {
+        int n = get_n();
+        std::vector<int> result(n + 1, -1);
+        int next = 0;
+        for (int v = 1; v <= n; v++) {
+            int root = find(v);
+            // A raiz é o menor vértice do conjunto, então já foi numerada quando v > root
+            result[v] = (root == v) ? next++ : result[root];
+        }
+        return result;
+    }
+};
+
+#endif
@@ -1,10 +1,22 @@
 #include "Graph.h"
+#include "EdgeReader.h"
+#include "Landmarks.h"
+#include "ContractionHierarchy.h"
 #include <cassert>
 #include <iostream>
 #include <limits>
 #include <chrono>
 #include <fstream>
+#include <sstream>
 #include <random>
+#include <queue>
+#include <cmath>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#endif
 
 auto time_now() {
     return std::chrono::steady_clock::now();
@@ -14,6 +26,29 @@ double time_elapsed(std::chrono::steady_clock::time_point start, std::chrono::st
     return std::chrono::duration<double>(end - start).count(); // seconds
 }
 
+/**
+Altera current e peak com a memória atual e o pico de memória do processo (working set no Windows, RSS no Linux), em MB. Se não conseguir medir, ambos ficam -1.
+*/
+void process_memory_mb(double& current, double& peak) {
+    current = -1;
+    peak = -1;
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        current = pmc.WorkingSetSize / (1024.0 * 1024.0);
+        peak = pmc.PeakWorkingSetSize / (1024.0 * 1024.0);
+    }
+#else
+    std::ifstream status("/proc/self/status");
+    std::string key;
+    while (status >> key) {
+        double kb;
+        if (key == "VmRSS:" && status >> kb) current = kb / 1024;
+        else if (key == "VmHWM:" && status >> kb) peak = kb / 1024;
+    }
+#endif
+}
+
 template <typename T>
 void write_vector(std::ofstream& outfile,const std::vector<T>& v) {
     for (int i = 0; i < v.size(); i++) {
@@ -159,6 +194,902 @@ void test_performance_dijkstra(const std::string& graph_file, const std::string&
     std::cout << no_optimization << "\n";
 }
 
+/**
+Mede o índice ALT com landmark_count landmarks: tempo de construção, memória das tabelas e tempo por consulta em pair_count pares aleatórios, comparado com dist_weighted (Dijkstra bidirecional). Confere que as distâncias são as mesmas.
+*/
+void test_performance_alt(const std::string& graph_file, const std::string& filename, int landmark_count, int pair_count) {
+    std::ofstream outfile(filename);
+    assert(outfile);
+
+    WeightedGraph wg(graph_file, RepresentationType::CSR);
+
+    int n = wg.get_n();
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<> dis(1, n);
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < pair_count; i++) {
+        pairs.push_back(std::make_pair(dis(gen), dis(gen)));
+    }
+
+    auto start = time_now();
+    LandmarkIndex index(wg, landmark_count);
+    double build_duration = time_elapsed(start, time_now());
+
+    std::vector<double> reference(pair_count);
+    start = time_now();
+    for (int i = 0; i < pair_count; i++) {
+        reference[i] = wg.dist_weighted(pairs[i].first, pairs[i].second);
+    }
+    double reference_duration = time_elapsed(start, time_now());
+
+    PointToPointWorkspace workspace;
+    long long bidirectional_settled = 0, alt_settled = 0;
+    for (int i = 0; i < pair_count; i++) {
+        bidirectional_settled += wg.shortest_path(pairs[i].first, pairs[i].second, workspace).settled;
+    }
+
+    std::vector<double> alt_dists(pair_count);
+    start = time_now();
+    for (int i = 0; i < pair_count; i++) {
+        PathQueryResult r = index.shortest_path(pairs[i].first, pairs[i].second, workspace);
+        alt_dists[i] = r.dist;
+        alt_settled += r.settled;
+    }
+    double alt_duration = time_elapsed(start, time_now());
+
+    bool same_dists = true;
+    for (int i = 0; i < pair_count; i++) {
+        if (alt_dists[i] != reference[i] && std::abs(alt_dists[i] - reference[i]) > 1e-9 * std::max(1.0, reference[i])) same_dists = false;
+    }
+
+    outfile << "Grafo: " << graph_file << "\n";
+    outfile << landmark_count << " landmarks, " << pair_count << " pares aleatórios\n\n";
+    outfile << "Construção do índice: " << build_duration << " segundos\n";
+    outfile << "Memória do índice: " << index.memory_bytes() / (1024.0 * 1024.0) << " MB\n";
+    outfile << "dist_weighted: média " << reference_duration / pair_count << " segundos (" << static_cast<double>(bidirectional_settled) / pair_count << " vértices explorados, com workspace)\n";
+    outfile << "A* bidirecional com landmarks: média " << alt_duration / pair_count << " segundos (" << static_cast<double>(alt_settled) / pair_count << " vértices explorados)\n";
+    outfile << "Aceleração: " << reference_duration / alt_duration << "x\n";
+    outfile << "Mesmas distâncias: " << (same_dists ? "sim" : "não") << "\n";
+}
+
+/**
+Retorna a soma dos pesos das arestas de path (usando a aresta mais leve entre cada par de vértices consecutivos), ou std::numeric_limits<double>::infinity() se algum par não for vizinho.
+*/
+double path_weight(const WeightedGraph& wg, const std::vector<int>& path) {
+    double length = 0;
+    for (int j = 0; j + 1 < path.size(); j++) {
+        double w = std::numeric_limits<double>::infinity();
+        for (const WeightedArc& a : wg.weighted_neighbors(path[j])) {
+            if (a.target == path[j + 1]) w = std::min(w, static_cast<double>(a.weight));
+        }
+        length += w;
+    }
+    return length;
+}
+
+/**
+Mede a ContractionHierarchy: tempo de construção, quantidade de atalhos, tempo para salvar e carregar de index_file e tempo por consulta em pair_count pares aleatórios (usando o índice carregado), comparado com dist_weighted. Confere as distâncias e que os caminhos expandidos são caminhos do grafo original com o peso certo.
+*/
+void test_performance_ch(const std::string& graph_file, const std::string& filename, const std::string& index_file, int pair_count) {
+    std::ofstream outfile(filename);
+    assert(outfile);
+
+    WeightedGraph wg(graph_file, RepresentationType::CSR);
+
+    int n = wg.get_n();
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<> dis(1, n);
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < pair_count; i++) {
+        pairs.push_back(std::make_pair(dis(gen), dis(gen)));
+    }
+
+    auto start = time_now();
+    double build_duration, save_duration, load_duration;
+    long long shortcuts;
+    {
+        ContractionHierarchy built(wg);
+        build_duration = time_elapsed(start, time_now());
+        shortcuts = built.shortcut_count();
+
+        start = time_now();
+        built.save(index_file);
+        save_duration = time_elapsed(start, time_now());
+    }
+
+    start = time_now();
+    ContractionHierarchy ch = ContractionHierarchy::load(index_file);
+    load_duration = time_elapsed(start, time_now());
+
+    std::vector<double> reference(pair_count);
+    start = time_now();
+    for (int i = 0; i < pair_count; i++) {
+        reference[i] = wg.dist_weighted(pairs[i].first, pairs[i].second);
+    }
+    double reference_duration = time_elapsed(start, time_now());
+
+    std::vector<PathQueryResult> results(pair_count);
+    PointToPointWorkspace workspace;
+    start = time_now();
+    for (int i = 0; i < pair_count; i++) {
+        results[i] = ch.shortest_path(pairs[i].first, pairs[i].second, workspace);
+    }
+    double ch_duration = time_elapsed(start, time_now());
+
+    bool same_dists = true, valid_paths = true;
+    long long settled = 0;
+    for (int i = 0; i < pair_count; i++) {
+        const PathQueryResult& r = results[i];
+        settled += r.settled;
+        if (r.dist != reference[i] && std::abs(r.dist - reference[i]) > 1e-9 * std::max(1.0, reference[i])) same_dists = false;
+        if (r.dist == std::numeric_limits<double>::infinity()) continue;
+
+        bool ok = !r.path.empty() && r.path.front() == pairs[i].first && r.path.back() == pairs[i].second;
+        if (!ok || std::abs(path_weight(wg, r.path) - r.dist) > 1e-9 * std::max(1.0, r.dist)) valid_paths = false;
+    }
+
+    outfile << "Grafo: " << graph_file << "\n";
+    outfile << pair_count << " pares aleatórios\n\n";
+    outfile << "Construção do índice: " << build_duration << " segundos, " << shortcuts << " atalhos\n";
+    outfile << "Salvar: " << save_duration << " segundos, carregar: " << load_duration << " segundos\n";
+    outfile << "dist_weighted: média " << reference_duration / pair_count << " segundos\n";
+    outfile << "Contraction Hierarchies: média " << ch_duration / pair_count << " segundos (" << static_cast<double>(settled) / pair_count << " vértices explorados)\n";
+    outfile << "Aceleração: " << reference_duration / ch_duration << "x\n";
+    outfile << "Mesmas distâncias: " << (same_dists ? "sim" : "não") << "\n";
+    outfile << "Caminhos válidos: " << (valid_paths ? "sim" : "não") << "\n";
+}
+
+/**
+Compara dist (BFS bidirecional) com uma BFS completa a partir de u, em pair_count pares aleatórios de vértices. Registra o tempo e a quantidade média de vértices alcançados por consulta em cada caso, e confere que as distâncias são as mesmas.
+*/
+void test_bidirectional_dist(const std::string& graph_file, const std::string& filename, int pair_count, RepresentationType type) {
+    std::ofstream outfile(filename);
+    assert(outfile);
+
+    Graph g(graph_file, type);
+
+    int n = g.get_n();
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<> dis(1, n);
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < pair_count; i++) {
+        pairs.push_back(std::make_pair(dis(gen), dis(gen)));
+    }
+
+    std::vector<int> full_dists(pair_count), bidirectional_dists(pair_count);
+    std::vector<int> levels, parents;
+    long long full_touched = 0;
+    auto start = time_now();
+    for (int i = 0; i < pair_count; i++) {
+        g.bfs(pairs[i].first, levels, parents);
+        full_dists[i] = levels[pairs[i].second];
+    }
+    double full_duration = time_elapsed(start, time_now());
+    for (int i = 0; i < pair_count; i++) {
+        g.bfs(pairs[i].first, levels, parents);
+        for (int l : levels) full_touched += l != -1;
+    }
+
+    long long bidirectional_touched = 0;
+    start = time_now();
+    for (int i = 0; i < pair_count; i++) {
+        int touched;
+        bidirectional_dists[i] = g.bidirectional_bfs(pairs[i].first, pairs[i].second, touched);
+        bidirectional_touched += touched;
+    }
+    double bidirectional_duration = time_elapsed(start, time_now());
+
+    outfile << "Grafo: " << graph_file << "\n";
+    outfile << pair_count << " pares aleatórios\n\n";
+    outfile << "BFS completa: média " << full_duration / pair_count << " segundos, " << static_cast<double>(full_touched) / pair_count << " vértices alcançados por consulta\n";
+    outfile << "BFS bidirecional: média " << bidirectional_duration / pair_count << " segundos, " << static_cast<double>(bidirectional_touched) / pair_count << " vértices alcançados por consulta\n";
+    outfile << "Mesmas distâncias: " << (full_dists == bidirectional_dists ? "sim" : "não") << "\n";
+}
+
+void question_bidirectional_dist() {
+    std::vector<std::pair<std::string, std::string>> graphs = {
+        {"Parte1/Grafos/grafo_1.txt", "Parte1/Resultados/dist_bidirecional_grafo_1.txt"},
+        //{"Grafos/Grandes/grafo_2.txt", "Parte1/Resultados/dist_bidirecional_grafo_2.txt"},
+        //{"Grafos/Grandes/grafo_3.txt", "Parte1/Resultados/dist_bidirecional_grafo_3.txt"},
+        //{"Grafos/Grandes/grafo_4.txt", "Parte1/Resultados/dist_bidirecional_grafo_4.txt"},
+        //{"Grafos/Grandes/grafo_5.txt", "Parte1/Resultados/dist_bidirecional_grafo_5.txt"},
+        //{"Grafos/Grandes/grafo_6.txt", "Parte1/Resultados/dist_bidirecional_grafo_6.txt"},
+    };
+
+    for (auto t : graphs) {
+        test_bidirectional_dist(t.first, t.second, 1000, RepresentationType::CSR);
+    }
+}
+
+/**
+Compara as estruturas de DijkstraQueue no mesmo grafo e com os mesmos vértices de início: heap preguiçosa, heap 4-ária indexada, heap radix e vetor. O caminho só com vetores é O(n^2), então roda só nos primeiros vector_only_count inícios (0 para pular).
+Também confere que todas as estruturas chegam às mesmas distâncias.
+*/
+void test_performance_dijkstra_queues(const std::string& graph_file, const std::string& filename, int dijkstra_count, int vector_only_count) {
+    std::ofstream outfile(filename);
+    assert(outfile);
+    int no_optimization = 0;
+
+    WeightedGraph wg(graph_file, RepresentationType::CSR);
+
+    int n = wg.get_n();
+    std::vector<double> dists(n + 1), reference(n + 1);
+    std::vector<int> parents(n + 1);
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<> dis(1, n);
+    std::vector<int> random_starts;
+    for (int i = 0; i < dijkstra_count; i++) {
+        random_starts.push_back(dis(gen));
+    }
+
+    outfile << "Grafo: " << graph_file << "\n";
+    outfile << "Vértices de início: ";
+    for (int s : random_starts) {
+        outfile << s << " ";
+    }
+    outfile << "\n\n";
+
+    std::vector<std::tuple<std::string, DijkstraQueue, int>> queues = {
+        {"Heap preguiçosa (std::priority_queue)", DijkstraQueue::LAZY_HEAP, dijkstra_count},
+        {"Heap 4-ária indexada (decrease-key)", DijkstraQueue::DARY_HEAP, dijkstra_count},
+        {"Heap radix (bits das distâncias)", DijkstraQueue::RADIX_HEAP, dijkstra_count},
+        {"Apenas vetores", DijkstraQueue::VECTOR_ONLY, std::min(vector_only_count, dijkstra_count)},
+    };
+
+    for (auto& q : queues) {
+        std::string name = std::get<0>(q);
+        DijkstraQueue queue = std::get<1>(q);
+        int count = std::get<2>(q);
+        if (count == 0) continue;
+
+        bool same_dists = true;
+        double duration = 0;
+        for (int i = 0; i < count; i++) {
+            int s = random_starts[i];
+            auto start = time_now();
+            wg.dijkstra(s, dists, parents, queue);
+            duration += time_elapsed(start, time_now());
+            no_optimization += static_cast<int>(dists[1]); // Só para garantir que ele não otimize a chamada
+
+            // A heap preguiçosa é a referência: as outras precisam chegar às mesmas distâncias
+            wg.dijkstra(s, reference, parents, DijkstraQueue::LAZY_HEAP);
+            if (dists != reference) same_dists = false;
+        }
+
+        outfile << name << ":\n";
+        outfile << "    Duração total das " << count << " chamadas: " << duration << " segundos\n";
+        outfile << "    Média por Dijkstra: " << duration / count << " segundos\n";
+        outfile << "    Mesmas distâncias da heap preguiçosa: " << (same_dists ? "sim" : "não") << "\n";
+    }
+
+    std::cout << no_optimization << "\n";
+}
+
+void question_2_queues() {
+    for (int i = 1; i <= 5; i++) {
+        std::string infile = "Grafos/Grandes/grafo_W_" + std::to_string(i) + ".txt";
+        std::string outfile = "EstudosDeCaso/Questao2/grafo_" + std::to_string(i) + "_filas.txt";
+        test_performance_dijkstra_queues(infile, outfile, 100, i <= 3 ? 10 : 1);
+    }
+}
+
+/**
+Compara dijkstra_batch (threads threads, 0 = todos os núcleos) com o laço sequencial de test_performance_dijkstra, nos mesmos dijkstra_count vértices de início e com a heap radix. Confere que cada vértice de início recebe as mesmas distâncias nos dois casos.
+*/
+void test_performance_dijkstra_batch(const std::string& graph_file, const std::string& filename, int dijkstra_count, int threads) {
+    std::ofstream outfile(filename);
+    assert(outfile);
+
+    WeightedGraph wg(graph_file, RepresentationType::CSR);
+
+    int n = wg.get_n();
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<> dis(1, n);
+    // Vértices de início distintos, para que cada resultado do lote tenha uma posição só
+    dijkstra_count = std::min(dijkstra_count, n);
+    std::vector<int> random_starts;
+    std::vector<int> index_of(n + 1, -1);
+    while (random_starts.size() < dijkstra_count) {
+        int s = dis(gen);
+        if (index_of[s] != -1) continue;
+        index_of[s] = random_starts.size();
+        random_starts.push_back(s);
+    }
+
+    // Soma das distâncias finitas de cada vértice de início: resume o resultado sem guardar n * dijkstra_count distâncias
+    auto finite_sum = [](const std::vector<double>& dists) {
+        double sum = 0;
+        for (double d : dists) {
+            if (d != std::numeric_limits<double>::infinity()) sum += d;
+        }
+        return sum;
+    };
+
+    std::vector<double> sequential_sums(dijkstra_count), batch_sums(dijkstra_count);
+    std::vector<double> dists;
+    std::vector<int> parents;
+    auto start = time_now();
+    for (int i = 0; i < dijkstra_count; i++) {
+        wg.dijkstra(random_starts[i], dists, parents, DijkstraQueue::RADIX_HEAP);
+        sequential_sums[i] = finite_sum(dists);
+    }
+    double sequential_duration = time_elapsed(start, time_now());
+
+    start = time_now();
+    wg.dijkstra_batch(random_starts, [&](int tid, int s, const std::vector<double>& d, const std::vector<int>& p) {
+        batch_sums[index_of[s]] = finite_sum(d); // Cada posição só é escrita pela thread que processou aquele início
+    }, DijkstraQueue::RADIX_HEAP, threads);
+    double batch_duration = time_elapsed(start, time_now());
+
+    outfile << "Grafo: " << graph_file << "\n";
+    outfile << dijkstra_count << " vértices de início, threads = " << threads << " (0 = todos os núcleos)\n\n";
+    outfile << "Sequencial: " << sequential_duration << " segundos\n";
+    outfile << "dijkstra_batch: " << batch_duration << " segundos\n";
+    outfile << "Mesmos resultados: " << (sequential_sums == batch_sums ? "sim" : "não") << "\n";
+}
+
+/**
+Compara consultas entre pares aleatórios de vértices: Dijkstra completo a partir da origem (como dist_weighted fazia antes) contra shortest_path (Dijkstra bidirecional, reaproveitando um PointToPointWorkspace). Confere as distâncias e o comprimento dos caminhos, e registra quantos vértices cada abordagem explora.
+*/
+void test_performance_shortest_path(const std::string& graph_file, const std::string& filename, int pair_count) {
+    std::ofstream outfile(filename);
+    assert(outfile);
+
+    WeightedGraph wg(graph_file, RepresentationType::CSR);
+
+    int n = wg.get_n();
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<> dis(1, n);
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < pair_count; i++) {
+        pairs.push_back(std::make_pair(dis(gen), dis(gen)));
+    }
+
+    std::vector<double> full_dists(pair_count);
+    std::vector<double> dists;
+    std::vector<int> parents;
+    DijkstraWorkspace dijkstra_workspace;
+    long long full_settled = 0;
+    auto start = time_now();
+    for (int i = 0; i < pair_count; i++) {
+        wg.dijkstra(pairs[i].first, dists, parents, DijkstraQueue::AUTO, dijkstra_workspace);
+        full_dists[i] = dists[pairs[i].second];
+    }
+    double full_duration = time_elapsed(start, time_now());
+    for (int i = 0; i < pair_count; i++) {
+        wg.dijkstra(pairs[i].first, dists, parents, DijkstraQueue::AUTO, dijkstra_workspace);
+        for (double d : dists) full_settled += d != std::numeric_limits<double>::infinity();
+    }
+
+    std::vector<PathQueryResult> results(pair_count);
+    PointToPointWorkspace workspace;
+    start = time_now();
+    for (int i = 0; i < pair_count; i++) {
+        results[i] = wg.shortest_path(pairs[i].first, pairs[i].second, workspace);
+    }
+    double bidirectional_duration = time_elapsed(start, time_now());
+
+    // As distâncias podem diferir no arredondamento, já que os caminhos são somados em outra ordem
+    bool same_dists = true, valid_paths = true;
+    long long bidirectional_settled = 0;
+    for (int i = 0; i < pair_count; i++) {
+        const PathQueryResult& r = results[i];
+        bidirectional_settled += r.settled;
+        if (std::abs(r.dist - full_dists[i]) > 1e-9 * std::max(1.0, full_dists[i]) && r.dist != full_dists[i]) same_dists = false;
+        if (r.dist == std::numeric_limits<double>::infinity()) {
+            if (!r.path.empty()) valid_paths = false;
+            continue;
+        }
+
+        // O caminho deve ir da origem ao destino por arestas existentes, somando r.dist
+        bool ok = !r.path.empty() && r.path.front() == pairs[i].first && r.path.back() == pairs[i].second;
+        if (!ok || std::abs(path_weight(wg, r.path) - r.dist) > 1e-9 * std::max(1.0, r.dist)) valid_paths = false;
+    }
+
+    outfile << "Grafo: " << graph_file << "\n";
+    outfile << pair_count << " pares aleatórios\n\n";
+    outfile << "Dijkstra completo: média " << full_duration / pair_count << " segundos, " << static_cast<double>(full_settled) / pair_count << " vértices explorados por consulta\n";
+    outfile << "Dijkstra bidirecional: média " << bidirectional_duration / pair_count << " segundos, " << static_cast<double>(bidirectional_settled) / pair_count << " vértices explorados por consulta\n";
+    outfile << "Mesmas distâncias: " << (same_dists ? "sim" : "não") << "\n";
+    outfile << "Caminhos válidos: " << (valid_paths ? "sim" : "não") << "\n";
+}
+
+/**
+Retorna se parents é uma árvore de caminhos mínimos coerente com dists: cada vértice alcançado (exceto s) tem como pai um vizinho p com dists[p] + peso(p, v) = dists[v], a menos de tolerance.
+*/
+bool valid_shortest_path_tree(const WeightedGraph& wg, int s, const std::vector<double>& dists, const std::vector<int>& parents, double tolerance) {
+    int n = wg.get_n();
+    for (int v = 1; v <= n; v++) {
+        if (v == s || dists[v] == std::numeric_limits<double>::infinity()) continue;
+        int p = parents[v];
+        if (p < 1 || p > n) return false;
+
+        bool found = false;
+        for (const WeightedArc& a : wg.weighted_neighbors(p)) {
+            if (a.target == v && std::abs(dists[p] + a.weight - dists[v]) <= tolerance) found = true;
+        }
+        if (!found) return false;
+    }
+    return true;
+}
+
+/**
+Compara o Δ-stepping (com threads threads e o delta dado; 0 para os valores automáticos) com o Dijkstra sequencial usando heap radix, nos mesmos vértices de início. Confere que as distâncias batem a menos de 1e-9 relativo e que parents é uma árvore de caminhos mínimos válida.
+*/
+void test_performance_delta_stepping(const std::string& graph_file, const std::string& filename, int dijkstra_count, int threads, double delta) {
+    std::ofstream outfile(filename);
+    assert(outfile);
+    int no_optimization = 0;
+
+    WeightedGraph wg(graph_file, RepresentationType::CSR);
+
+    int n = wg.get_n();
+    std::vector<double> dists(n + 1), reference(n + 1);
+    std::vector<int> parents(n + 1), reference_parents(n + 1);
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<> dis(1, n);
+    std::vector<int> random_starts;
+    for (int i = 0; i < dijkstra_count; i++) {
+        random_starts.push_back(dis(gen));
+    }
+
+    double dijkstra_duration = 0, delta_duration = 0;
+    bool same_dists = true, valid_parents = true;
+    for (int s : random_starts) {
+        auto start = time_now();
+        wg.dijkstra(s, reference, reference_parents, DijkstraQueue::RADIX_HEAP);
+        dijkstra_duration += time_elapsed(start, time_now());
+
+        start = time_now();
+        wg.delta_stepping(s, dists, parents, delta, threads);
+        delta_duration += time_elapsed(start, time_now());
+        no_optimization += static_cast<int>(dists[1]); // Só para garantir que ele não otimize a chamada
+
+        for (int v = 1; v <= n; v++) {
+            if (reference[v] == dists[v]) continue;
+            if (std::abs(reference[v] - dists[v]) > 1e-9 * std::max(1.0, reference[v])) same_dists = false;
+        }
+        if (!valid_shortest_path_tree(wg, s, dists, parents, 1e-9 * std::max(1.0, dists[s]) + 1e-6)) valid_parents = false;
+    }
+
+    outfile << "Grafo: " << graph_file << "\n";
+    outfile << dijkstra_count << " vértices de início, threads = " << threads << " (0 = todos os núcleos), delta = " << delta << " (0 = automático)\n\n";
+    outfile << "Dijkstra (heap radix), média: " << dijkstra_duration / dijkstra_count << " segundos\n";
+    outfile << "Δ-stepping, média: " << delta_duration / dijkstra_count << " segundos\n";
+    outfile << "Mesmas distâncias: " << (same_dists ? "sim" : "não") << "\n";
+    outfile << "Árvore de caminhos mínimos válida: " << (valid_parents ? "sim" : "não") << "\n";
+
+    std::cout << no_optimization << "\n";
+}
+
+/**
+BFS como era feita antes de neighbor_view: copia a lista de adjacências de cada vértice visitado para um std::vector<int> novo. Serve só de comparação em test_performance_bfs.
+*/
+void bfs_copying_neighbors(const Graph& g, int s, std::vector<int>& levels, std::vector<int>& parents) {
+    int n = g.get_n();
+    levels.assign(n + 1, -1);
+    parents.assign(n + 1, -1);
+
+    std::queue<int> Q;
+    levels[s] = 0;
+    parents[s] = s;
+    Q.push(s);
+    while (!Q.empty()) {
+        int v = Q.front();
+        Q.pop();
+        NeighborView view = g.neighbor_view(v);
+        std::vector<int> nb(view.begin(), view.end()); // A cópia que a versão antiga fazia
+        for (int i = 0; i < nb.size(); i++) {
+            int w = nb[i];
+            if (levels[w] == -1) {
+                levels[w] = levels[v] + 1;
+                parents[w] = v;
+                Q.push(w);
+            }
+        }
+    }
+}
+
+/**
+Compara a vazão da BFS copiando as listas de adjacências (antes) com a BFS usando neighbor_view (depois), a partir dos mesmos vértices aleatórios.
+*/
+void test_performance_bfs(const std::string& graph_file, const std::string& filename, int bfs_count) {
+    std::ofstream outfile(filename);
+    assert(outfile);
+
+    Graph g(graph_file, false);
+    int n = g.get_n();
+    std::vector<int> levels;
+    std::vector<int> parents;
+    long long no_optimization = 0;
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<> dis(1, n);
+    std::vector<int> random_starts;
+    for (int i = 0; i < bfs_count; i++) {
+        random_starts.push_back(dis(gen));
+    }
+
+    auto start = time_now();
+    for (int s : random_starts) {
+        bfs_copying_neighbors(g, s, levels, parents);
+        no_optimization += levels[1];
+    }
+    auto end = time_now();
+    double before = time_elapsed(start, end);
+
+    start = time_now();
+    for (int s : random_starts) {
+        g.bfs(s, levels, parents);
+        no_optimization += levels[1];
+    }
+    end = time_now();
+    double after = time_elapsed(start, end);
+
+    outfile << bfs_count << " BFS em " << graph_file << "\n";
+    outfile << "Copiando os vizinhos (antes): " << before << " segundos (" << bfs_count/before << " BFS/s)\n";
+    outfile << "Com neighbor_view (depois): " << after << " segundos (" << bfs_count/after << " BFS/s)\n";
+    outfile << "Aceleração: " << before/after << "x\n";
+
+    std::cout << no_optimization << "\n";
+}
+
+/**
+Compara a bfs usual com a bfs que otimiza a direção, a partir dos mesmos vértices aleatórios. Também confere que os níveis encontrados são iguais.
+*/
+void test_performance_bfs_direction_optimizing(const std::string& graph_file, const std::string& filename, int bfs_count) {
+    std::ofstream outfile(filename);
+    assert(outfile);
+
+    Graph g(graph_file, RepresentationType::CSR);
+    int n = g.get_n();
+    std::vector<int> levels, levels_do;
+    std::vector<int> parents, parents_do;
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<> dis(1, n);
+    std::vector<int> random_starts;
+    for (int i = 0; i < bfs_count; i++) {
+        random_starts.push_back(dis(gen));
+    }
+
+    double top_down = 0;
+    double direction_optimizing = 0;
+    bool same_levels = true;
+    for (int s : random_starts) {
+        auto start = time_now();
+        g.bfs(s, levels, parents);
+        auto middle = time_now();
+        g.bfs_direction_optimizing(s, levels_do, parents_do);
+        auto end = time_now();
+
+        top_down += time_elapsed(start, middle);
+        direction_optimizing += time_elapsed(middle, end);
+        if (levels != levels_do) same_levels = false;
+    }
+
+    outfile << bfs_count << " BFS em " << graph_file << " (CSR)\n";
+    outfile << "bfs: " << top_down << " segundos\n";
+    outfile << "bfs_direction_optimizing: " << direction_optimizing << " segundos\n";
+    outfile << "Aceleração: " << top_down/direction_optimizing << "x\n";
+    outfile << "Níveis iguais: " << (same_levels ? "sim" : "NÃO") << "\n";
+}
+
+/**
+Escrita da bfs como era feita antes de BufferedWriter: std::ofstream com operator<< linha a linha. Serve só de comparação em test_performance_write_bfs.
+*/
+void write_bfs_with_ofstream(const Graph& g, int s, const std::string& filename) {
+    std::vector<int> dists;
+    std::vector<int> parents;
+    g.bfs(s, dists, parents);
+
+    std::ofstream outfile(filename);
+    assert(outfile);
+
+    outfile << "Nível -1 significa não descoberto. Nível 0 e pai iguai a si significa raiz da árvore geradora induzida" << "\n";
+    outfile << "\n";
+    int n = g.get_n();
+    for (int v = 1; v <= n; v++) {
+        outfile << "Vértice " << v << ": pai " << parents[v] << " e nível " << dists[v] << "\n";
+    }
+}
+
+/**
+Compara o tempo de write_bfs com std::ofstream (antes), com BufferedWriter em texto e em binário, a partir do mesmo vértice. Confere que os dois textos são iguais e que o binário tem os mesmos pais e níveis da bfs.
+Os arquivos são escritos em output_prefix + "_ofstream.txt", "_texto.txt" e "_binario.bin".
+*/
+void test_performance_write_bfs(const std::string& graph_file, const std::string& filename, const std::string& output_prefix) {
+    std::ofstream outfile(filename);
+    assert(outfile);
+
+    Graph g(graph_file, RepresentationType::CSR);
+    int n = g.get_n();
+    std::vector<int> levels;
+    std::vector<int> parents;
+    g.bfs(1, levels, parents);
+
+    std::string ofstream_file = output_prefix + "_ofstream.txt";
+    std::string text_file = output_prefix + "_texto.txt";
+    std::string binary_file = output_prefix + "_binario.bin";
+
+    auto start = time_now();
+    write_bfs_with_ofstream(g, 1, ofstream_file);
+    double ofstream_duration = time_elapsed(start, time_now());
+
+    start = time_now();
+    g.write_bfs(1, text_file, OutputFormat::TEXT);
+    double text_duration = time_elapsed(start, time_now());
+
+    start = time_now();
+    g.write_bfs(1, binary_file, OutputFormat::BINARY);
+    double binary_duration = time_elapsed(start, time_now());
+
+    std::ifstream a(ofstream_file), b(text_file);
+    std::stringstream ofstream_text, buffered_text;
+    ofstream_text << a.rdbuf();
+    buffered_text << b.rdbuf();
+
+    // Cabeçalho de 32 bytes, depois pais e níveis (n + 1 inteiros cada)
+    std::ifstream binary(binary_file, std::ios::binary);
+    binary.seekg(32);
+    std::vector<int> binary_parents(n + 1), binary_levels(n + 1);
+    binary.read(reinterpret_cast<char*>(binary_parents.data()), (n + 1) * sizeof(int));
+    binary.read(reinterpret_cast<char*>(binary_levels.data()), (n + 1) * sizeof(int));
+
+    outfile << "Grafo: " << graph_file << " (" << n << " vértices)\n\n";
+    outfile << "Tempos incluem a bfs\n";
+    outfile << "std::ofstream: " << ofstream_duration << " segundos\n";
+    outfile << "BufferedWriter, texto: " << text_duration << " segundos\n";
+    outfile << "BufferedWriter, binário: " << binary_duration << " segundos\n";
+    outfile << "Textos iguais: " << (ofstream_text.str() == buffered_text.str() ? "sim" : "não") << "\n";
+    outfile << "Binário com os pais e níveis da bfs: " << (binary && binary_parents == parents && binary_levels == levels ? "sim" : "não") << "\n";
+}
+
+/**
+Calcula o diâmetro exato com iFUB e escreve o algoritmo usado, a quantidade de BFS feitas (comparada com as n BFS de diameter()) e o tempo.
+*/
+void test_ifub_diameter(const std::string& graph_file, const std::string& filename) {
+    std::ofstream outfile(filename);
+    assert(outfile);
+
+    Graph g(graph_file, RepresentationType::CSR);
+
+    auto start = time_now();
+    DiameterResult result = g.ifub_diameter();
+    auto end = time_now();
+
+    outfile << "Grafo: " << graph_file << "\n";
+    outfile << "Diâmetro: " << result.diameter << "\n";
+    outfile << "Algoritmo: " << result.algorithm << "\n";
+    outfile << "Chamadas de BFS: " << result.bfs_calls << " (diameter() faria " << g.get_n() << ")\n";
+    outfile << "Tempo: " << time_elapsed(start, end) << " segundos\n";
+}
+
+/**
+Compara os engines de componentes conexas: BFS e union-find sobre o grafo já construído, e union-find direto do arquivo (sem construir o grafo; o tempo inclui a leitura). Confere que as três listas de componentes são iguais.
+*/
+void test_performance_components(const std::string& graph_file, const std::string& filename, int threads) {
+    std::ofstream outfile(filename);
+    assert(outfile);
+
+    auto start = time_now();
+    std::vector<std::vector<int>> from_file = Graph::connected_components_from_file(graph_file, threads);
+    double from_file_duration = time_elapsed(start, time_now());
+
+    Graph g(graph_file, RepresentationType::CSR);
+
+    start = time_now();
+    std::vector<std::vector<int>> by_bfs = g.connected_components(ComponentsEngine::BFS);
+    double bfs_duration = time_elapsed(start, time_now());
+
+    start = time_now();
+    std::vector<std::vector<int>> by_union_find = g.connected_components(ComponentsEngine::UNION_FIND, threads);
+    double union_find_duration = time_elapsed(start, time_now());
+
+    outfile << "Grafo: " << graph_file << "\n";
+    outfile << "Componentes: " << by_bfs.size() << ", threads = " << threads << " (0 = todos os núcleos)\n\n";
+    outfile << "BFS: " << bfs_duration << " segundos\n";
+    outfile << "Union-find: " << union_find_duration << " segundos\n";
+    outfile << "Union-find lendo o arquivo: " << from_file_duration << " segundos\n";
+    outfile << "Mesmos resultados: " << (by_bfs == by_union_find && by_bfs == from_file ? "sim" : "não") << "\n";
+}
+
+/**
+Leitura das arestas como era feita antes de EdgeReader: ifstream com extração formatada. Serve só de comparação em test_load_time.
+*/
+void read_with_ifstream(const std::string& filename, int& n, std::vector<std::pair<int, int>>& edges) {
+    std::ifstream infile(filename);
+    assert(infile);
+
+    infile >> n;
+    edges.resize(0);
+    int u, v;
+    while (infile >> u >> v) {
+        edges.push_back(std::make_pair(u, v));
+    }
+}
+
+/**
+Mede, para cada grafo de Parte1/Grafos, o tempo de ler as arestas com ifstream, com o leitor paralelo, e o tempo de construir o grafo inteiro (CSR). Arquivos que não existem são pulados.
+*/
+void test_load_time(const std::string& filename) {
+    std::ofstream outfile(filename);
+    assert(outfile);
+
+    for (int i = 1; i <= 6; i++) {
+        std::string graph_file = "Parte1/Grafos/grafo_" + std::to_string(i) + ".txt";
+        if (!std::ifstream(graph_file)) {
+            outfile << graph_file << ": arquivo não encontrado\n\n";
+            continue;
+        }
+
+        int n;
+        std::vector<std::pair<int, int>> edges;
+
+        auto start = time_now();
+        read_with_ifstream(graph_file, n, edges);
+        auto end = time_now();
+        double ifstream_time = time_elapsed(start, end);
+
+        start = time_now();
+        read_edge_list(graph_file, 0, n, edges);
+        end = time_now();
+        double parallel_time = time_elapsed(start, end);
+
+        start = time_now();
+        Graph g(graph_file, RepresentationType::CSR);
+        end = time_now();
+        double build_time = time_elapsed(start, end);
+
+        outfile << graph_file << ": " << n << " vértices, " << edges.size() << " arestas\n";
+        outfile << "Leitura com ifstream: " << ifstream_time << " segundos\n";
+        outfile << "Leitura com EdgeReader: " << parallel_time << " segundos (" << ifstream_time/parallel_time << "x)\n";
+        outfile << "Construção do grafo (CSR): " << build_time << " segundos\n\n";
+    }
+}
+
+/**
+Converte um grafo do formato de texto para o formato binário de Graph::save_binary, e escreve o tempo de carregar cada um dos dois formatos.
+*/
+void convert_to_binary(const std::string& text_file, const std::string& binary_file, bool weighted, const std::string& filename) {
+    std::ofstream outfile(filename);
+    assert(outfile);
+
+    double text_time, binary_time;
+    if (weighted) {
+        auto start = time_now();
+        WeightedGraph wg(text_file, RepresentationType::CSR);
+        text_time = time_elapsed(start, time_now());
+        wg.save_binary(binary_file);
+
+        start = time_now();
+        WeightedGraph loaded = WeightedGraph::load_binary(binary_file);
+        binary_time = time_elapsed(start, time_now());
+    } else {
+        auto start = time_now();
+        Graph g(text_file, RepresentationType::CSR);
+        text_time = time_elapsed(start, time_now());
+        g.save_binary(binary_file);
+
+        start = time_now();
+        Graph loaded = Graph::load_binary(binary_file);
+        binary_time = time_elapsed(start, time_now());
+    }
+
+    outfile << text_file << " -> " << binary_file << "\n";
+    outfile << "Carregar o texto: " << text_time << " segundos\n";
+    outfile << "Carregar o binário: " << binary_time << " segundos\n";
+}
+
+/**
+Constrói o WeightedGraph (CSR) e escreve a memória antes, depois e o pico durante a construção. Com a construção em duas passadas, o pico deve ficar perto da memória final.
+Deve ser chamada no começo do programa, antes de outros grafos grandes, para o pico não ser de outra coisa.
+*/
+void test_memory_weighted(const std::string& graph_file, const std::string& filename) {
+    std::ofstream outfile(filename);
+    assert(outfile);
+
+    double before, peak_before, after, peak_after;
+    process_memory_mb(before, peak_before);
+
+    auto start = time_now();
+    WeightedGraph wg(graph_file, RepresentationType::CSR);
+    auto end = time_now();
+
+    process_memory_mb(after, peak_after);
+
+    outfile << "Grafo: " << graph_file << " (" << wg.get_n() << " vértices)\n";
+    outfile << "Tempo de construção: " << time_elapsed(start, end) << " segundos\n";
+    outfile << "Memória antes: " << before << " MB\n";
+    outfile << "Memória depois (grafo pronto): " << after << " MB\n";
+    outfile << "Pico de memória: " << peak_after << " MB\n";
+    outfile << "Tamanho do grafo: " << after - before << " MB; pico acima do início: " << peak_after - before << " MB\n";
+}
+
+/**
+Calcula a distribuição de graus do grafo e escreve um resumo (percentis e ajuste de lei de potência) e o tempo de cada etapa. A distribuição também é exportada em CSV (csv_file) e em binário (binary_file), e o binário é carregado de volta para conferir.
+*/
+void test_degree_distribution(const std::string& graph_file, const std::string& filename, const std::string& csv_file, const std::string& binary_file, int threads) {
+    std::ofstream outfile(filename);
+    assert(outfile);
+
+    Graph g(graph_file, RepresentationType::CSR);
+
+    auto start = time_now();
+    DegreeDistribution distribution = g.degree_distribution(threads);
+    double distribution_duration = time_elapsed(start, time_now());
+
+    start = time_now();
+    PowerLawFit fit = distribution.power_law_fit(threads);
+    double fit_duration = time_elapsed(start, time_now());
+
+    distribution.write_csv(csv_file);
+    distribution.save(binary_file, threads);
+    DegreeDistribution loaded = DegreeDistribution::load(binary_file);
+
+    outfile << "Grafo: " << graph_file << ", threads = " << threads << " (0 = todos os núcleos)\n";
+    outfile << "Vértices: " << distribution.get_n() << ", arestas: " << distribution.edges() << "\n";
+    outfile << "Grau mínimo: " << distribution.min_degree() << ", máximo: " << distribution.max_degree() << ", médio: " << distribution.mean() << ", mediana: " << distribution.median() << "\n";
+    outfile << "Percentis:";
+    for (double p : {1.0, 10.0, 25.0, 50.0, 75.0, 90.0, 99.0, 99.9}) {
+        outfile << " p" << p << " = " << distribution.percentile(p) << ";";
+    }
+    outfile << "\n";
+    outfile << "Lei de potência: alpha = " << fit.alpha << ", d_min = " << fit.d_min << " (" << fit.tail_vertices << " vértices na cauda), distância KS = " << fit.ks_distance << "\n\n";
+    outfile << "Distribuição: " << distribution_duration << " segundos\n";
+    outfile << "Ajuste da lei de potência: " << fit_duration << " segundos\n";
+    outfile << "Binário carregado igual: " << (loaded.get_histogram() == distribution.get_histogram() ? "sim" : "não") << "\n";
+}
+
+/**
+Gera o relatório de write_output de duas formas: com Graph::write_output_from_file, lendo o arquivo sem construir o grafo, e construindo o grafo (CSR) e chamando write_output. Escreve o tempo e o pico de memória de cada uma e confere que os relatórios são iguais.
+Deve ser chamada no começo do programa, como test_memory_weighted. A versão sem grafo roda primeiro, para que o seu pico não inclua o grafo.
+*/
+void test_write_output_from_file(const std::string& graph_file, const std::string& filename, const std::string& report_prefix, int threads) {
+    std::ofstream outfile(filename);
+    assert(outfile);
+
+    std::string streamed_report = report_prefix + "_streaming.txt";
+    std::string graph_report = report_prefix + "_grafo.txt";
+
+    double before, peak_before, after_streaming, peak_streaming, after_graph, peak_graph;
+    process_memory_mb(before, peak_before);
+
+    auto start = time_now();
+    Graph::write_output_from_file(graph_file, streamed_report, threads);
+    double streaming_duration = time_elapsed(start, time_now());
+    process_memory_mb(after_streaming, peak_streaming);
+
+    start = time_now();
+    {
+        Graph g(graph_file, RepresentationType::CSR);
+        g.write_output(graph_report);
+    }
+    double graph_duration = time_elapsed(start, time_now());
+    process_memory_mb(after_graph, peak_graph);
+
+    std::ifstream a(streamed_report), b(graph_report);
+    std::stringstream streamed_text, graph_text;
+    streamed_text << a.rdbuf();
+    graph_text << b.rdbuf();
+
+    outfile << "Grafo: " << graph_file << ", threads = " << threads << " (0 = todos os núcleos)\n\n";
+    outfile << "Sem construir o grafo: " << streaming_duration << " segundos, pico acima do início: " << peak_streaming - before << " MB\n";
+    outfile << "Construindo o grafo: " << graph_duration << " segundos, pico acima do início: " << peak_graph - before << " MB\n";
+    outfile << "Relatórios iguais: " << (streamed_text.str() == graph_text.str() ? "sim" : "não") << "\n";
+}
+
 void question_2() {
     std::vector<std::tuple<std::string, std::string, bool, int>> graphs = {
         //{"Grafos/Grandes/grafo_W_1.txt", "EstudosDeCaso/Questao2/grafo_1_heap.txt", false, 100},
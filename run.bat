@@ -1,5 +1,11 @@
 g++ -c Representation.cpp -O3 -m64
 g++ -c Graph.cpp -O3 -m64
+g++ -c EdgeReader.cpp -O3 -m64
+g++ -c MappedFile.cpp -O3 -m64
+g++ -c Landmarks.cpp -O3 -m64
+g++ -c ContractionHierarchy.cpp -O3 -m64
+g++ -c DegreeDistribution.cpp -O3 -m64
+g++ -c OutputWriter.cpp -O3 -m64
 g++ -c main.cpp -O3 -m64
-g++ Representation.o Graph.o main.o -O3 -o main.exe -m64
+g++ Representation.o EdgeReader.o MappedFile.o Graph.o Landmarks.o ContractionHierarchy.o DegreeDistribution.o OutputWriter.o main.o -O3 -o main.exe -m64 -pthread -lpsapi
 .\main.exe
\ No newline at end of file